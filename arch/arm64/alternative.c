@@ -0,0 +1,50 @@
+#include <alternative.h>
+#include <arch_help.h>
+#include <cpufeature.h>
+#include <stdio.h>
+
+/* Kopernik.ld */
+extern const struct alt_instr __alt_instructions[];
+extern const struct alt_instr __alt_instructions_end[];
+
+static u32 *alt_orig_ptr(const struct alt_instr *alt)
+{
+	return (u32 *)((uintptr_t)&alt->orig_offset + alt->orig_offset);
+}
+
+static const u32 *alt_repl_ptr(const struct alt_instr *alt)
+{
+	return (const u32 *)((uintptr_t)&alt->alt_offset + alt->alt_offset);
+}
+
+/*
+ * Patch every site whose feature is present. Runs once on the boot CPU
+ * after cpu_features_init() and before any other CPU is started, so no
+ * one can be executing a site while it changes. Nothing in here may use
+ * an alternative itself.
+ */
+void apply_alternatives(void)
+{
+	const struct alt_instr *alt;
+	unsigned int patched = 0, total = 0;
+	unsigned int i;
+	u32 *orig;
+	const u32 *repl;
+
+	for (alt = __alt_instructions; alt < __alt_instructions_end; alt++) {
+		total++;
+		if (!cpu_has(alt->feature))
+			continue;
+
+		orig = alt_orig_ptr(alt);
+		repl = alt_repl_ptr(alt);
+		for (i = 0; i < alt->orig_len / sizeof(u32); i++)
+			orig[i] = repl[i];
+
+		/* DC CVAU, IC IVAU as far as CTR_EL0 asks for them, then ISB */
+		sync_icache_range((uintptr_t)orig, alt->orig_len);
+		patched++;
+	}
+
+	printf("alternatives: patched %u of %u sites\n", patched, total);
+}
@@ -0,0 +1,123 @@
+#include <arch.h>
+#include <cache.h>
+#include <cpufeature.h>
+#include <msr.h>
+#include <stdio.h>
+
+/* CLIDR_EL1 fields */
+#define CLIDR_CTYPE_WIDTH	3
+#define CLIDR_LOUIS(clidr)	(((clidr) >> 21) & 0x7)
+#define CLIDR_LOC(clidr)	(((clidr) >> 24) & 0x7)
+#define CLIDR_LOUU(clidr)	(((clidr) >> 27) & 0x7)
+
+/* CTR_EL0 fields, line sizes are log2 of the number of words */
+#define CTR_FIELD(ctr, shift)	(((ctr) >> (shift)) & 0xf)
+#define CTR_CWG_SHIFT		24
+
+/* DCZID_EL0 fields */
+#define DCZID_BS_MASK		0xf
+#define DCZID_DZP		BIT(4)
+
+#define CSSELR_IND		BIT(0)
+
+struct cache_info cache_info;
+
+_Static_assert(offsetof(struct cache_info, zva_block_size) ==
+	       CACHE_INFO_ZVA_BLOCK_SIZE, "memset reads zva_block_size");
+
+/* Read the geometry of one cache through CSSELR_EL1/CCSIDR_EL1 */
+static void read_geometry(unsigned int level, bool icache, bool ccidx,
+			  struct cache_geometry *geo)
+{
+	u64 ccsidr;
+
+	write_msr(csselr_el1, (level << LEVEL_SHIFT) | (icache ? CSSELR_IND : 0));
+	__asm__ volatile("isb" ::: "memory");
+	ccsidr = read_msr(ccsidr_el1);
+
+	geo->line_size = 1U << ((ccsidr & 0x7) + 4);
+	if (ccidx) {
+		geo->ways = ((ccsidr >> 3) & 0x1fffff) + 1;
+		geo->sets = ((ccsidr >> 32) & 0xffffff) + 1;
+	} else {
+		geo->ways = ((ccsidr >> 3) & 0x3ff) + 1;
+		geo->sets = ((ccsidr >> 13) & 0x7fff) + 1;
+	}
+	geo->size = geo->line_size * geo->sets * geo->ways;
+}
+
+static void cache_print(void)
+{
+	static const char *const names[] = {
+		"none", "I", "D", "I+D", "unified",
+	};
+	const struct cache_level *l;
+	unsigned int i;
+
+	printf("cache: %u levels, LoC %u LoUIS %u, dline %u iline %u zva %u\n",
+	       cache_info.levels, cache_info.loc, cache_info.louis,
+	       cache_info.dminline, cache_info.iminline,
+	       cache_info.zva_block_size);
+
+	for (i = 0; i < cache_info.levels; i++) {
+		l = &cache_info.level[i];
+		printf("  L%u %s", i + 1, names[l->type]);
+		if (l->type == CACHE_TYPE_INST || l->type == CACHE_TYPE_SEPARATE)
+			printf(" i: %uK %u-way %u sets %uB lines",
+			       l->icache.size >> 10, l->icache.ways,
+			       l->icache.sets, l->icache.line_size);
+		if (l->type != CACHE_TYPE_INST)
+			printf(" d: %uK %u-way %u sets %uB lines",
+			       l->dcache.size >> 10, l->dcache.ways,
+			       l->dcache.sets, l->dcache.line_size);
+		printf("\n");
+	}
+}
+
+/*
+ * Discover the cache hierarchy, must run before the cache_* queries and
+ * after cpu_features_init()
+ */
+void cache_init(void)
+{
+	u64 ctr = read_msr(ctr_el0);
+	u64 clidr = read_msr(clidr_el1);
+	u64 dczid = read_msr(dczid_el0);
+	bool ccidx = cpu_has(CPU_FEAT_CCIDX);
+	struct cache_level *l;
+	unsigned int i, type;
+
+	cache_info.dminline = 4U << CTR_FIELD(ctr, CTR_DMINLINE_SHIFT);
+	cache_info.iminline = 4U << CTR_FIELD(ctr, CTR_IMINLINE_SHIFT);
+	cache_info.cwg = CTR_FIELD(ctr, CTR_CWG_SHIFT) ?
+			 4U << CTR_FIELD(ctr, CTR_CWG_SHIFT) : 0;
+	cache_info.idc = (ctr >> CTR_IDC_SHIFT) & 1;
+	cache_info.dic = (ctr >> CTR_DIC_SHIFT) & 1;
+
+	cache_info.zva_block_size = (dczid & DCZID_DZP) ?
+				    0 : 4U << (dczid & DCZID_BS_MASK);
+
+	cache_info.loc = CLIDR_LOC(clidr);
+	cache_info.louis = CLIDR_LOUIS(clidr);
+	cache_info.louu = CLIDR_LOUU(clidr);
+
+	for (i = 0; i < CACHE_MAX_LEVELS; i++) {
+		type = (clidr >> (i * CLIDR_CTYPE_WIDTH)) & 0x7;
+		if (type == CACHE_TYPE_NONE || type > CACHE_TYPE_UNIFIED)
+			break;
+
+		l = &cache_info.level[i];
+		l->type = type;
+		if (type != CACHE_TYPE_INST)
+			read_geometry(i, false, ccidx, &l->dcache);
+		if (type == CACHE_TYPE_INST || type == CACHE_TYPE_SEPARATE)
+			read_geometry(i, true, ccidx, &l->icache);
+	}
+	cache_info.levels = i;
+
+	/* Leave CSSELR_EL1 at its reset selection, as dcsw_op_all() does */
+	write_msr(csselr_el1, 0);
+	__asm__ volatile("isb" ::: "memory");
+
+	cache_print();
+}
@@ -0,0 +1,138 @@
+#include <arch.h>
+#include <cpufeature.h>
+#include <msr.h>
+#include <stdio.h>
+
+/* ID register fields are 4 bits wide */
+#define ID_FIELD(reg, shift)	(((reg) >> (shift)) & 0xf)
+
+/* ID_AA64ISAR0_EL1 */
+#define ISAR0_CRC32_SHIFT	16
+#define ISAR0_ATOMIC_SHIFT	20
+#define ISAR0_TLB_SHIFT		56
+
+/* ID_AA64ISAR1_EL1 */
+#define ISAR1_LRCPC_SHIFT	20
+
+/* ID_AA64ISAR2_EL1 */
+#define ISAR2_MOPS_SHIFT	16
+
+/* ID_AA64PFR0_EL1, FP and AdvSIMD read 0xf when not implemented */
+#define PFR0_FP_SHIFT		16
+#define PFR0_ASIMD_SHIFT	20
+
+/* ID_AA64MMFR0_EL1 */
+#define MMFR0_PARANGE_SHIFT	0
+#define MMFR0_TGRAN16_SHIFT	20
+#define MMFR0_TGRAN64_SHIFT	24
+#define MMFR0_TGRAN4_SHIFT	28
+
+/* ID_AA64MMFR1_EL1 */
+#define MMFR1_HAFDBS_SHIFT	0
+
+/* ID_AA64MMFR2_EL1 */
+#define MMFR2_BBM_SHIFT		52
+
+/* ID_AA64DFR0_EL1, PMUVer 0xf is an IMPLEMENTATION DEFINED PMU */
+#define DFR0_PMUVER_SHIFT	8
+#define DFR0_PMUVER_IMP_DEF	0xf
+
+struct cpu_features cpu_features;
+
+static const unsigned int pa_range_bits[] = {
+	32, 36, 40, 42, 44, 48, 52, 56,
+};
+
+static const char *const feature_names[CPU_NR_FEATURES] = {
+	[CPU_FEAT_FP]		= "fp",
+	[CPU_FEAT_ASIMD]	= "asimd",
+	[CPU_FEAT_CRC32]	= "crc32",
+	[CPU_FEAT_LSE]		= "lse",
+	[CPU_FEAT_MOPS]		= "mops",
+	[CPU_FEAT_TLBI_OS]	= "tlbios",
+	[CPU_FEAT_TLBI_RANGE]	= "tlbirange",
+	[CPU_FEAT_HAF]		= "haf",
+	[CPU_FEAT_HDBS]		= "hdbs",
+	[CPU_FEAT_CONT_HINT]	= "cont",
+	[CPU_FEAT_BBM]		= "bbm",
+	[CPU_FEAT_CCIDX]	= "ccidx",
+	[CPU_FEAT_GRAN_4K]	= "4k",
+	[CPU_FEAT_GRAN_16K]	= "16k",
+	[CPU_FEAT_GRAN_64K]	= "64k",
+	[CPU_FEAT_PMU]		= "pmu",
+	[CPU_FEAT_LRCPC]	= "lrcpc",
+};
+
+static void set_cap(unsigned int feat, bool present)
+{
+	if (present)
+		cpu_features.caps |= 1UL << feat;
+}
+
+static void cpu_features_print(void)
+{
+	unsigned int i;
+
+	printf("cpu: pa %u bits, pmuv %u, bbm %u, features:",
+	       cpu_features.pa_bits, cpu_features.pmu_version,
+	       cpu_features.bbm_level);
+	for (i = 0; i < CPU_NR_FEATURES; i++)
+		if (cpu_has(i))
+			printf(" %s", feature_names[i]);
+	printf("\n");
+}
+
+/* Read the ID registers once, must run before any cpu_has() query */
+void cpu_features_init(void)
+{
+	u64 isar0 = read_msr(id_aa64isar0_el1);
+	u64 isar1 = read_msr(id_aa64isar1_el1);
+	u64 isar2 = read_msr(S3_0_C0_C6_2);	/* ID_AA64ISAR2_EL1 */
+	u64 pfr0 = read_msr(id_aa64pfr0_el1);
+	u64 mmfr0 = read_msr(id_aa64mmfr0_el1);
+	u64 mmfr1 = read_msr(id_aa64mmfr1_el1);
+	u64 mmfr2 = read_msr(id_aa64mmfr2_el1);
+	u64 dfr0 = read_msr(id_aa64dfr0_el1);
+	unsigned int parange, pmuver;
+
+	cpu_features.caps = 0;
+
+	set_cap(CPU_FEAT_FP, ID_FIELD(pfr0, PFR0_FP_SHIFT) != 0xf);
+	set_cap(CPU_FEAT_ASIMD, ID_FIELD(pfr0, PFR0_ASIMD_SHIFT) != 0xf);
+
+	set_cap(CPU_FEAT_CRC32, ID_FIELD(isar0, ISAR0_CRC32_SHIFT) >= 1);
+	set_cap(CPU_FEAT_LSE, ID_FIELD(isar0, ISAR0_ATOMIC_SHIFT) >= 2);
+	set_cap(CPU_FEAT_TLBI_OS, ID_FIELD(isar0, ISAR0_TLB_SHIFT) >= 1);
+	set_cap(CPU_FEAT_TLBI_RANGE, ID_FIELD(isar0, ISAR0_TLB_SHIFT) >= 2);
+	set_cap(CPU_FEAT_LRCPC, ID_FIELD(isar1, ISAR1_LRCPC_SHIFT) >= 1);
+	set_cap(CPU_FEAT_MOPS, ID_FIELD(isar2, ISAR2_MOPS_SHIFT) >= 1);
+
+	set_cap(CPU_FEAT_HAF, ID_FIELD(mmfr1, MMFR1_HAFDBS_SHIFT) >= 1);
+	set_cap(CPU_FEAT_HDBS, ID_FIELD(mmfr1, MMFR1_HAFDBS_SHIFT) >= 2);
+
+	/*
+	 * The contiguous bit is part of the base architecture, there is no
+	 * ID field for it. Whether a TLB makes use of it is not visible.
+	 */
+	set_cap(CPU_FEAT_CONT_HINT, true);
+	cpu_features.bbm_level = ID_FIELD(mmfr2, MMFR2_BBM_SHIFT);
+	set_cap(CPU_FEAT_BBM, cpu_features.bbm_level >= 1);
+	set_cap(CPU_FEAT_CCIDX,
+		ID_FIELD(mmfr2, ID_AA64MMFR2_CCIDX_SHIFT) >= 1);
+
+	/* TGran4 and TGran64 use 0xf for not supported, TGran16 uses 0 */
+	set_cap(CPU_FEAT_GRAN_4K, ID_FIELD(mmfr0, MMFR0_TGRAN4_SHIFT) != 0xf);
+	set_cap(CPU_FEAT_GRAN_16K, ID_FIELD(mmfr0, MMFR0_TGRAN16_SHIFT) != 0);
+	set_cap(CPU_FEAT_GRAN_64K, ID_FIELD(mmfr0, MMFR0_TGRAN64_SHIFT) != 0xf);
+
+	parange = ID_FIELD(mmfr0, MMFR0_PARANGE_SHIFT);
+	if (parange >= sizeof(pa_range_bits) / sizeof(pa_range_bits[0]))
+		parange = 0;
+	cpu_features.pa_bits = pa_range_bits[parange];
+
+	pmuver = ID_FIELD(dfr0, DFR0_PMUVER_SHIFT);
+	cpu_features.pmu_version = pmuver == DFR0_PMUVER_IMP_DEF ? 0 : pmuver;
+	set_cap(CPU_FEAT_PMU, cpu_features.pmu_version != 0);
+
+	cpu_features_print();
+}
@@ -0,0 +1,96 @@
+/*
+ * boot time instruction patching
+ *
+ * A site emits its default instructions in place and a replacement of
+ * the same length into .altinstr_replacement, plus a struct alt_instr in
+ * .altinstructions. apply_alternatives() copies the replacement over
+ * the default for every site whose CPU_FEAT_* the CPU has, so the
+ * choice costs nothing at run time.
+ *
+ * Replacements are copied verbatim, they must not contain PC relative
+ * instructions (branches, ADR, literal loads). Branches in the default
+ * sequence are fine as long as they stay inside the site or leave it
+ * for a fixed address.
+ */
+#ifndef __ALTERNATIVE_H__
+#define __ALTERNATIVE_H__
+
+#include <cpufeature.h>
+
+#define ALT_INSTR_SIZE		12
+
+#ifndef __ASM__
+#include <types.h>
+
+struct alt_instr {
+	s32 orig_offset;	/* default instructions, relative to here */
+	s32 alt_offset;		/* replacement, relative to here */
+	u16 feature;		/* CPU_FEAT_* that selects the replacement */
+	u8 orig_len;		/* bytes */
+	u8 alt_len;		/* bytes, same as orig_len */
+};
+
+void apply_alternatives(void);
+
+#define __ALT_STR(x)		#x
+#define ALT_STR(x)		__ALT_STR(x)
+
+/*
+ * ALTERNATIVE(default, replacement, feature) for inline assembly. The two
+ * strings must assemble to the same size.
+ */
+#define ALTERNATIVE(oldinstr, newinstr, feature)			\
+	"661:\n\t"							\
+	oldinstr "\n"							\
+	"662:\n"							\
+	".pushsection .altinstructions, \"a\"\n"			\
+	"	.word	661b - .\n"					\
+	"	.word	663f - .\n"					\
+	"	.hword	" ALT_STR(feature) "\n"				\
+	"	.byte	662b - 661b\n"					\
+	"	.byte	664f - 663f\n"					\
+	".popsection\n"							\
+	".pushsection .altinstr_replacement, \"ax\"\n"			\
+	"663:\n\t"							\
+	newinstr "\n"							\
+	"664:\n"							\
+	"	.org	. - (664b - 663b) + (662b - 661b)\n"		\
+	"	.org	. - (662b - 661b) + (664b - 663b)\n"		\
+	".popsection\n"
+
+#else /* __ASM__ */
+
+/*
+ * alternative_if_not CPU_FEAT_X
+ *	default instructions
+ * alternative_else
+ *	replacement
+ * alternative_endif
+ */
+	.macro	alternative_if_not feature
+	.pushsection .altinstructions, "a"
+	.word	661f - .
+	.word	663f - .
+	.hword	\feature
+	.byte	662f - 661f
+	.byte	664f - 663f
+	.popsection
+661:
+	.endm
+
+	.macro	alternative_else
+662:
+	.pushsection .altinstr_replacement, "ax"
+663:
+	.endm
+
+	.macro	alternative_endif
+664:
+	.org	. - (664b - 663b) + (662b - 661b)
+	.org	. - (662b - 661b) + (664b - 663b)
+	.popsection
+	.endm
+
+#endif /* __ASM__ */
+
+#endif /* __ALTERNATIVE_H__ */
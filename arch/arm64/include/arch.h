@@ -19,8 +19,44 @@
 #define DAIFSET_ABT		BIT(2)
 #define DAIFSET_DBG		BIT(3)
 
+/* the same bits, for the enable_irq()/disable_irq() helpers */
+#define DAIF_FIQ_BIT		DAIFSET_FIQ
+#define DAIF_IRQ_BIT		DAIFSET_IRQ
+#define DAIF_ABT_BIT		DAIFSET_ABT
+#define DAIF_DBG_BIT		DAIFSET_DBG
+
+/* HCR_EL2: take physical IRQs to EL2 */
+#define HCR_IMO			BIT(4)
+
 #define SPSR_MODE_EL0T		(0x0)
 #define SPSR_MODE_EL1T		(0x4)
 #define SPSR_MODE_EL1H		(0x5)
 
+/* CPTR_EL2 with HCR_EL2.E2H == 0 */
+#define CPTR_EL2_TFP		BIT(10)
+
+/* CTR_EL0, cache type register */
+#define CTR_IMINLINE_SHIFT	0
+#define CTR_DMINLINE_SHIFT	16
+#define CTR_MINLINE_WIDTH	4
+#define CTR_IDC_SHIFT		28
+#define CTR_DIC_SHIFT		29
+
+/* CLIDR_EL1, cache level ID register */
+#define CLIDR_LOUIS_SHIFT	21
+#define CLIDR_LOC_SHIFT		24
+#define CLIDR_FIELD_WIDTH	3
+
+/* CSSELR_EL1 level field starts at bit 1 */
+#define LEVEL_SHIFT		1
+
+/* ID_AA64MMFR2_EL1.CCIDX, 64-bit CCSIDR_EL1 format */
+#define ID_AA64MMFR2_CCIDX_SHIFT	20
+#define ID_AA64MMFR2_CCIDX_WIDTH	4
+
+/* Set/way operations for dcsw_op_all() and dcsw_op_louis() */
+#define DCISW			0x0
+#define DCCISW			0x1
+#define DCCSW			0x2
+
 #endif /* __ARCH_H__ */
@@ -55,14 +55,14 @@
 #define DEFINE_SYSOP_FUNC(_op)                                                 \
 	static inline void _op(void)                                           \
 	{                                                                      \
-		__asm__(#_op);                                                 \
+		__asm__(#_op ::: "memory");                                    \
 	}
 
 /* Define function for system instruction with type specifier */
 #define DEFINE_SYSOP_TYPE_FUNC(_op, _type)                                     \
 	static inline void _op##_type(void)                                    \
 	{                                                                      \
-		__asm__(#_op " " #_type);                                      \
+		__asm__(#_op " " #_type ::: "memory");                         \
 	}
 
 /* Define function for system instruction with register parameter */
@@ -105,7 +105,9 @@ DEFINE_SYSOP_TYPE_PARAM_FUNC(dc, cvau)
 DEFINE_SYSOP_TYPE_PARAM_FUNC(dc, zva)
 
 void flush_dcache_range(uint64_t, uint64_t);
+void clean_dcache_range(uint64_t, uint64_t);
 void inv_dcache_range(uint64_t, uint64_t);
+void sync_icache_range(uint64_t, uint64_t);
 void dcsw_op_louis(uint32_t);
 void dcsw_op_all(uint32_t);
 
@@ -132,6 +134,26 @@ DEFINE_SYSREG_READ_FUNC(id_pfr1_el1)
 DEFINE_SYSREG_READ_FUNC(id_aa64pfr0_el1)
 DEFINE_SYSREG_READ_FUNC(CurrentEl)
 DEFINE_SYSREG_RW_FUNCS(daif)
+
+/*
+ * Mask IRQs on this CPU and return the DAIF value to hand back to
+ * local_irq_restore(). Unlike disable_irq(), these order memory
+ * accesses around them, so they can bracket a critical section.
+ */
+static inline uint64_t local_irq_save(void)
+{
+	uint64_t flags;
+
+	__asm__ volatile("mrs	%0, daif\n"
+			 "msr	daifset, %1"
+			 : "=r"(flags) : "i"(DAIF_IRQ_BIT) : "memory");
+	return flags;
+}
+
+static inline void local_irq_restore(uint64_t flags)
+{
+	__asm__ volatile("msr	daif, %0" : : "r"(flags) : "memory");
+}
 DEFINE_SYSREG_RW_FUNCS(spsr_el1)
 DEFINE_SYSREG_RW_FUNCS(spsr_el2)
 DEFINE_SYSREG_RW_FUNCS(spsr_el3)
@@ -143,6 +165,8 @@ DEFINE_SYSOP_FUNC(wfi)
 DEFINE_SYSOP_FUNC(wfe)
 DEFINE_SYSOP_FUNC(sev)
 DEFINE_SYSOP_TYPE_FUNC(dsb, sy)
+DEFINE_SYSOP_TYPE_FUNC(dsb, ish)
+DEFINE_SYSOP_TYPE_FUNC(dsb, ishst)
 DEFINE_SYSOP_FUNC(isb)
 
 uint32_t get_afflvl_shift(uint32_t);
@@ -238,6 +262,10 @@ DEFINE_RENAME_SYSREG_RW_FUNCS(icc_sre_el1, ICC_SRE_EL1)
 DEFINE_RENAME_SYSREG_RW_FUNCS(icc_sre_el2, ICC_SRE_EL2)
 DEFINE_RENAME_SYSREG_RW_FUNCS(icc_sre_el3, ICC_SRE_EL3)
 DEFINE_RENAME_SYSREG_RW_FUNCS(icc_pmr_el1, ICC_PMR_EL1)
+DEFINE_RENAME_SYSREG_RW_FUNCS(icc_bpr1_el1, ICC_BPR1_EL1)
+DEFINE_RENAME_SYSREG_RW_FUNCS(icc_igrpen1_el1, ICC_IGRPEN1_EL1)
+_DEFINE_SYSREG_READ_FUNC(icc_iar1_el1, ICC_IAR1_EL1)
+_DEFINE_SYSREG_WRITE_FUNC(icc_eoir1_el1, ICC_EOIR1_EL1)
 
 #define IS_IN_EL(x) (GET_EL(read_CurrentEl()) == MODE_EL##x)
 
@@ -0,0 +1,126 @@
+/*
+ * atomic counters
+ *
+ * The default sequences are LL/SC loops, patched to the single LSE
+ * instruction on CPUs with CPU_FEAT_LSE. All operations that return a
+ * value are fully ordered.
+ */
+#ifndef __ATOMIC_H__
+#define __ATOMIC_H__
+
+#include <alternative.h>
+
+typedef struct {
+	volatile int counter;
+} atomic_t;
+
+#define ATOMIC_INIT(i)		{ (i) }
+
+#define __LSE_PREAMBLE		".arch_extension lse\n"
+
+static inline int atomic_read(const atomic_t *v)
+{
+	return v->counter;
+}
+
+static inline void atomic_set(atomic_t *v, int i)
+{
+	v->counter = i;
+}
+
+/* Add i to v and return the old value */
+static inline int atomic_fetch_add(int i, atomic_t *v)
+{
+	unsigned int fail;
+	int old, tmp;
+
+	__asm__ volatile(ALTERNATIVE(
+	"1:	ldxr	%w[old], %[v]\n"
+	"	add	%w[tmp], %w[old], %w[i]\n"
+	"	stlxr	%w[fail], %w[tmp], %[v]\n"
+	"	cbnz	%w[fail], 1b\n"
+	"	dmb	ish",
+	__LSE_PREAMBLE
+	"	ldaddal	%w[i], %w[old], %[v]\n"
+	"	nop\n"
+	"	nop\n"
+	"	nop\n"
+	"	nop",
+	CPU_FEAT_LSE)
+	: [old] "=&r" (old), [tmp] "=&r" (tmp), [fail] "=&r" (fail),
+	  [v] "+Q" (v->counter)
+	: [i] "r" (i)
+	: "memory");
+
+	return old;
+}
+
+/* Store i in v and return the old value */
+static inline int atomic_xchg(atomic_t *v, int i)
+{
+	unsigned int fail;
+	int old;
+
+	__asm__ volatile(ALTERNATIVE(
+	"1:	ldxr	%w[old], %[v]\n"
+	"	stlxr	%w[fail], %w[i], %[v]\n"
+	"	cbnz	%w[fail], 1b\n"
+	"	dmb	ish",
+	__LSE_PREAMBLE
+	"	swpal	%w[i], %w[old], %[v]\n"
+	"	nop\n"
+	"	nop\n"
+	"	nop",
+	CPU_FEAT_LSE)
+	: [old] "=&r" (old), [fail] "=&r" (fail), [v] "+Q" (v->counter)
+	: [i] "r" (i)
+	: "memory");
+
+	return old;
+}
+
+/* Store new in v if it holds old, return the value v held */
+static inline int atomic_cmpxchg(atomic_t *v, int old, int new)
+{
+	unsigned int tmp;
+	int prev;
+
+	__asm__ volatile(ALTERNATIVE(
+	"1:	ldxr	%w[prev], %[v]\n"
+	"	eor	%w[tmp], %w[prev], %w[old]\n"
+	"	cbnz	%w[tmp], 2f\n"
+	"	stlxr	%w[tmp], %w[new], %[v]\n"
+	"	cbnz	%w[tmp], 1b\n"
+	"	dmb	ish\n"
+	"2:",
+	__LSE_PREAMBLE
+	"	mov	%w[prev], %w[old]\n"
+	"	casal	%w[prev], %w[new], %[v]\n"
+	"	nop\n"
+	"	nop\n"
+	"	nop\n"
+	"	nop",
+	CPU_FEAT_LSE)
+	: [prev] "=&r" (prev), [tmp] "=&r" (tmp), [v] "+Q" (v->counter)
+	: [old] "r" (old), [new] "r" (new)
+	: "memory");
+
+	return prev;
+}
+
+static inline int atomic_add_return(int i, atomic_t *v)
+{
+	return atomic_fetch_add(i, v) + i;
+}
+
+static inline int atomic_sub_return(int i, atomic_t *v)
+{
+	return atomic_fetch_add(-i, v) - i;
+}
+
+#define atomic_inc(v)		((void)atomic_fetch_add(1, (v)))
+#define atomic_dec(v)		((void)atomic_fetch_add(-1, (v)))
+#define atomic_inc_return(v)	atomic_add_return(1, (v))
+#define atomic_dec_return(v)	atomic_sub_return(1, (v))
+
+#endif /* __ATOMIC_H__ */
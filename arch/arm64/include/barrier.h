@@ -0,0 +1,63 @@
+/*
+ * memory barriers between CPUs
+ *
+ * Load-acquire uses LDAPR on CPUs with CPU_FEAT_LRCPC: RCpc ordering is
+ * all an acquire/release pair needs, and unlike LDAR it does not have
+ * to wait for earlier store-releases to complete.
+ */
+#ifndef __BARRIER_H__
+#define __BARRIER_H__
+
+#include <alternative.h>
+
+/* the compiler only, against an interrupt handler on the same CPU */
+#define barrier()	__asm__ volatile("" ::: "memory")
+
+#define smp_mb()	__asm__ volatile("dmb ish" ::: "memory")
+#define smp_rmb()	__asm__ volatile("dmb ishld" ::: "memory")
+#define smp_wmb()	__asm__ volatile("dmb ishst" ::: "memory")
+
+/* between memory accesses a device observes, e.g. virtqueues */
+#define dma_mb()	__asm__ volatile("dmb osh" ::: "memory")
+#define dma_rmb()	__asm__ volatile("dmb oshld" ::: "memory")
+#define dma_wmb()	__asm__ volatile("dmb oshst" ::: "memory")
+
+static inline unsigned int smp_load_acquire_32(const volatile u32 *p)
+{
+	unsigned int v;
+
+	__asm__ volatile(ALTERNATIVE(
+	"	ldar	%w0, %1",
+	".arch_extension rcpc\n"
+	"	ldapr	%w0, %1",
+	CPU_FEAT_LRCPC)
+	: "=r" (v) : "Q" (*p) : "memory");
+
+	return v;
+}
+
+static inline unsigned long smp_load_acquire_64(const volatile u64 *p)
+{
+	unsigned long v;
+
+	__asm__ volatile(ALTERNATIVE(
+	"	ldar	%0, %1",
+	".arch_extension rcpc\n"
+	"	ldapr	%0, %1",
+	CPU_FEAT_LRCPC)
+	: "=r" (v) : "Q" (*p) : "memory");
+
+	return v;
+}
+
+static inline void smp_store_release_32(volatile u32 *p, u32 v)
+{
+	__asm__ volatile("stlr %w1, %0" : "=Q" (*p) : "r" (v) : "memory");
+}
+
+static inline void smp_store_release_64(volatile u64 *p, u64 v)
+{
+	__asm__ volatile("stlr %1, %0" : "=Q" (*p) : "r" (v) : "memory");
+}
+
+#endif /* __BARRIER_H__ */
@@ -0,0 +1,75 @@
+/*
+ * cache topology, filled from CTR_EL0, CLIDR_EL1, CCSIDR_EL1 and DCZID_EL0
+ */
+#ifndef __CACHE_H__
+#define __CACHE_H__
+
+/* CLIDR_EL1 allows up to 7 levels of cache */
+#define CACHE_MAX_LEVELS	7
+
+/* Ctype<n> encodings of CLIDR_EL1 */
+#define CACHE_TYPE_NONE		0U
+#define CACHE_TYPE_INST		1U
+#define CACHE_TYPE_DATA		2U
+#define CACHE_TYPE_SEPARATE	3U
+#define CACHE_TYPE_UNIFIED	4U
+
+/* offsetof(struct cache_info, zva_block_size), for memset */
+#define CACHE_INFO_ZVA_BLOCK_SIZE	0
+
+#ifndef __ASM__
+#include <stdbool.h>
+#include <stddef.h>
+#include <types.h>
+
+struct cache_geometry {
+	u32 line_size;		/* bytes */
+	u32 sets;
+	u32 ways;
+	u32 size;		/* bytes */
+};
+
+struct cache_level {
+	unsigned int type;		/* CACHE_TYPE_* */
+	struct cache_geometry dcache;	/* data or unified cache */
+	struct cache_geometry icache;	/* instruction cache */
+};
+
+struct cache_info {
+	/*
+	 * DC ZVA block in bytes, 0 if prohibited or before cache_init().
+	 * First, memset reads it from assembly.
+	 */
+	u32 zva_block_size;
+
+	unsigned int levels;	/* number of implemented levels */
+	unsigned int loc;	/* level of coherency */
+	unsigned int louis;	/* level of unification inner shareable */
+	unsigned int louu;	/* level of unification uniprocessor */
+
+	/* smallest lines in the system, from CTR_EL0 */
+	u32 dminline;
+	u32 iminline;
+	u32 cwg;		/* cache writeback granule, 0 if unknown */
+	bool idc;		/* no dcache clean needed for I/D coherence */
+	bool dic;		/* no icache invalidate needed for I/D coherence */
+
+	struct cache_level level[CACHE_MAX_LEVELS];
+};
+
+extern struct cache_info cache_info;
+
+void cache_init(void);
+
+static inline u32 cache_dline_size(void)
+{
+	return cache_info.dminline;
+}
+
+static inline u32 cache_zva_block_size(void)
+{
+	return cache_info.zva_block_size;
+}
+#endif /* __ASM__ */
+
+#endif /* __CACHE_H__ */
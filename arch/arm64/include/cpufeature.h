@@ -0,0 +1,61 @@
+/*
+ * cpu features, filled once at boot from the ID_AA64*_EL1 registers
+ */
+#ifndef __CPUFEATURE_H__
+#define __CPUFEATURE_H__
+
+#ifndef __ASM__
+#include <stdbool.h>
+#include <types.h>
+#endif
+
+/* Feature numbers, also used by the alternatives in assembly */
+#define CPU_FEAT_FP		0	/* floating point */
+#define CPU_FEAT_ASIMD		1	/* Advanced SIMD */
+#define CPU_FEAT_CRC32		2	/* CRC32 instructions */
+#define CPU_FEAT_LSE		3	/* large system extension atomics */
+#define CPU_FEAT_MOPS		4	/* CPY* and SET* memory instructions */
+#define CPU_FEAT_TLBI_OS	5	/* outer shareable TLBI */
+#define CPU_FEAT_TLBI_RANGE	6	/* TLBI by address range */
+#define CPU_FEAT_HAF		7	/* hardware access flag update */
+#define CPU_FEAT_HDBS		8	/* hardware dirty state update */
+#define CPU_FEAT_CONT_HINT	9	/* contiguous bit in descriptors */
+#define CPU_FEAT_BBM		10	/* relaxed break-before-make levels */
+#define CPU_FEAT_CCIDX		11	/* 64-bit CCSIDR_EL1 format */
+#define CPU_FEAT_GRAN_4K	12	/* stage 1 translation granules */
+#define CPU_FEAT_GRAN_16K	13
+#define CPU_FEAT_GRAN_64K	14
+#define CPU_FEAT_PMU		15	/* PMUv3 */
+#define CPU_FEAT_LRCPC		16	/* LDAPR, RCpc load-acquire */
+#define CPU_NR_FEATURES		17
+
+#ifndef __ASM__
+struct cpu_features {
+	unsigned long caps;	/* bitmap of CPU_FEAT_* */
+	unsigned int pa_bits;	/* physical address size */
+	unsigned int pmu_version; /* ID_AA64DFR0_EL1.PMUVer, 0 if none */
+	unsigned int bbm_level;	/* ID_AA64MMFR2_EL1.BBM */
+};
+
+extern struct cpu_features cpu_features;
+
+void cpu_features_init(void);
+
+/* Valid once cpu_features_init() has run, false before that */
+static inline bool cpu_has(unsigned int feat)
+{
+	return cpu_features.caps & (1UL << feat);
+}
+
+static inline unsigned int cpu_pa_bits(void)
+{
+	return cpu_features.pa_bits;
+}
+
+static inline unsigned int cpu_pmu_version(void)
+{
+	return cpu_features.pmu_version;
+}
+#endif /* __ASM__ */
+
+#endif /* __CPUFEATURE_H__ */
@@ -24,6 +24,12 @@
 
 #define GET_EL(_mode)		(((_mode) >> MODE_EL_SHIFT) & MODE_EL_MASK)
 
+#define ESR_EC_SHIFT		26
+#define ESR_EC_UNKNOWN		0x00	/* undefined instruction, among others */
+#define ESR_EC_FP_ASIMD		0x07	/* trapped FP/SIMD access */
+
+#define SEMIHOST_HLT		0xd45e0000	/* HLT #0xF000 */
+
 #define ESR_EC(esr)		(((esr) >> 26) & BIT_MASK(6))
 #define ESR_IL(esr)		(((esr) >> 25) & BIT_MASK(1))
 #define ESR_ISS(esr)		((esr) & BIT_MASK(25))
@@ -0,0 +1,35 @@
+#ifndef __FPSIMD_H__
+#define __FPSIMD_H__
+
+/*
+ * FP/SIMD register file. Only used with CONFIG_SIMD, where EL2 runs with
+ * CPTR_EL2.TFP clear and the NEON string routines use the Q registers.
+ */
+
+#define FPSIMD_VREGS_OFFSET	0
+#define FPSIMD_FPSR_OFFSET	512
+#define FPSIMD_FPCR_OFFSET	520
+#define FPSIMD_STATE_SIZE	528
+
+#ifndef __ASM__
+struct fpsimd_state {
+	unsigned long vregs[64];	/* q0-q31, low half first */
+	unsigned long fpsr;
+	unsigned long fpcr;
+};
+
+void fpsimd_save_state(struct fpsimd_state *state);
+void fpsimd_load_state(const struct fpsimd_state *state);
+
+/*
+ * Lazy save around exception handlers that return: enter traps FP/SIMD
+ * so the interrupted state is saved by the trap handler on first use
+ * only, exit restores it if that happened and stops trapping. The C
+ * handlers themselves are built with -mgeneral-regs-only, only the
+ * libc routines they call can touch the Q registers.
+ */
+void fpsimd_exception_enter(void);
+void fpsimd_exception_exit(void);
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * static keys
+ *
+ * static_branch_unlikely(&key) compiles to a single NOP in front of the
+ * fast path, the guarded code is placed out of line. Enabling the key
+ * patches every such NOP into a B to that code, disabling patches the
+ * NOP back, so a disabled debug path costs one NOP and nothing else.
+ *
+ * Each branch site records its NOP, its target and its key in the
+ * __jump_table section, all as offsets relative to the entry.
+ */
+#ifndef __JUMP_LABEL_H__
+#define __JUMP_LABEL_H__
+
+#include <stdbool.h>
+#include <types.h>
+
+struct static_key {
+	int enabled;
+};
+
+struct jump_entry {
+	s32 code;		/* the NOP */
+	s32 target;		/* the out of line code */
+	s64 key;		/* struct static_key */
+};
+
+#define DEFINE_STATIC_KEY_FALSE(name)	struct static_key name = { 0 }
+#define DECLARE_STATIC_KEY_FALSE(name)	extern struct static_key name
+
+static inline __attribute__((always_inline))
+bool arch_static_branch(struct static_key *key)
+{
+	__asm__ goto(
+		"1:	nop\n"
+		"	.pushsection __jump_table, \"a\"\n"
+		"	.balign	8\n"
+		"	.long	1b - ., %l[l_yes] - .\n"
+		"	.quad	%c0 - .\n"
+		"	.popsection\n"
+		: : "i" (key) : : l_yes);
+	return false;
+l_yes:
+	return true;
+}
+
+#define static_branch_unlikely(key)	arch_static_branch(key)
+
+static inline bool static_key_enabled(const struct static_key *key)
+{
+	return key->enabled;
+}
+
+/* Patch all branch sites of key, safe to call before the MMU is on */
+void static_key_enable(struct static_key *key);
+void static_key_disable(struct static_key *key);
+
+#endif /* __JUMP_LABEL_H__ */
@@ -2,6 +2,8 @@
 #define __MMU_H__
 
 #include <stddef.h>
+#include <log.h>
+#include <types.h>
 
 #define CONFIG_ARM64_VA_BITS 32
 #define CONFIG_MMU_PAGE_SIZE 0x1000
@@ -11,23 +13,25 @@
 #define XLAT_TABLE_ENTRIES  512
 #define XLAT_TABLE_BASE_LEVEL 1
 
+/* VA window handed out by ioremap(), above the 1GB of RAM at 0x40000000 */
+#define CONFIG_IOREMAP_BASE	0xc0000000UL
+#define CONFIG_IOREMAP_SIZE	0x40000000UL
 
-#define __aligned(x)	__attribute__((__aligned__(x)))
 
-#define MMU_DEBUG_PRINTS	1
+#define __aligned(x)	__attribute__((__aligned__(x)))
 
 /* To get prints from MMU driver, it has to initialized after console driver */
 #define MMU_DEBUG_PRIORITY	70
 
-#if MMU_DEBUG_PRINTS
-/* To dump page table entries while filling them, set DUMP_PTE macro */
-#define DUMP_PTE		1
-#define MMU_DEBUG(fmt, ...)	printf(fmt, ##__VA_ARGS__)
-#else
-#define MMU_DEBUG(...)
-#endif
+/*
+ * MMU diagnostics, in the LOG_MMU subsystem: LOG_DEBUG for the regions
+ * being mapped and blocks being split, LOG_TRACE to dump every entry
+ * written. Both are compiled in by default and off at run time, a NOP
+ * each, turn them on with log_set_level(LOG_MMU, ...) before the first
+ * add_map().
+ */
+#define mmu_log(level, fmt, ...)	log_printf(LOG_MMU, level, fmt, ##__VA_ARGS__)
 
-#if DUMP_PTE
 #define L0_SPACE ""
 #define L1_SPACE "  "
 #define L2_SPACE "    "
@@ -36,7 +40,6 @@
 	(((level) == 0) ? L0_SPACE :		\
 	((level) == 1) ? L1_SPACE :		\
 	((level) == 2) ? L2_SPACE : L3_SPACE)
-#endif
 
 /*
  * 48-bit address with 4KB granule size:
@@ -255,6 +258,20 @@ void add_map(const char *name,
 		    unsigned long phys, unsigned long virt, int size, unsigned int attrs);
 void enable_mmu();
 
+/*
+ * Take translation tables from "tables" (nr of them, 4K aligned) instead of
+ * the static pool and drop every existing mapping. Before enable_mmu() only.
+ */
+void mmu_set_xlat_tables(u64 (*tables)[XLAT_TABLE_ENTRIES], unsigned int nr);
+u64 *mmu_base_xlat_table(void);
+
+/*
+ * Map a device region into the ioremap window. "type" is one of the MT_DEVICE_*
+ * types for registers, or MT_NORMAL_NC for write-combining buffers.
+ * Returns the virtual address of "phys", or NULL if the window is exhausted.
+ */
+void *ioremap(unsigned long phys, size_t size, unsigned int type);
+
 #define GENMASK(h, l) \
 	(((~0UL) - (1UL << (l)) + 1) & (~0UL >> (64 - 1 - (h))))
 
@@ -0,0 +1,63 @@
+#include <arch_help.h>
+#include <jump_label.h>
+
+#define AARCH64_INSN_NOP	0xd503201fU
+#define AARCH64_INSN_B		0x14000000U
+#define AARCH64_INSN_B_IMM_MASK	0x03ffffffU
+
+/* Kopernik.ld */
+extern struct jump_entry __start___jump_table[];
+extern struct jump_entry __stop___jump_table[];
+
+static u32 *jump_entry_code(const struct jump_entry *entry)
+{
+	return (u32 *)((uintptr_t)&entry->code + entry->code);
+}
+
+static uintptr_t jump_entry_target(const struct jump_entry *entry)
+{
+	return (uintptr_t)&entry->target + entry->target;
+}
+
+static struct static_key *jump_entry_key(const struct jump_entry *entry)
+{
+	return (struct static_key *)((uintptr_t)&entry->key + entry->key);
+}
+
+static void jump_label_update(struct static_key *key, bool enable)
+{
+	struct jump_entry *entry;
+	u32 *code;
+	s64 offset;
+
+	key->enabled = enable;
+
+	for (entry = __start___jump_table; entry < __stop___jump_table;
+	     entry++) {
+		if (jump_entry_key(entry) != key)
+			continue;
+
+		code = jump_entry_code(entry);
+		offset = (s64)(jump_entry_target(entry) - (uintptr_t)code);
+		if (enable)
+			*code = AARCH64_INSN_B |
+				((offset >> 2) & AARCH64_INSN_B_IMM_MASK);
+		else
+			*code = AARCH64_INSN_NOP;
+
+		/* A single aligned word store, no CPU sees half an update */
+		sync_icache_range((uintptr_t)code, sizeof(*code));
+	}
+}
+
+void static_key_enable(struct static_key *key)
+{
+	if (!key->enabled)
+		jump_label_update(key, true);
+}
+
+void static_key_disable(struct static_key *key)
+{
+	if (key->enabled)
+		jump_label_update(key, false);
+}
@@ -1,7 +1,9 @@
 #include <arch.h>
 #include <arch_help.h>
 #include <mmu.h>
+#include <msr.h>
 #include <stdio.h>
+#include <sizes.h>
 #include <stdlib.h>
 #include <string.h>
 #include <types.h>
@@ -9,9 +11,14 @@
 static u64 base_xlat_table[NUM_BASE_LEVEL_ENTRIES]
 __aligned(0x1000);
 
-static u64 xlat_tables[CONFIG_MAX_XLAT_TABLES][XLAT_TABLE_ENTRIES]
+static u64 prealloc_xlat_tables[CONFIG_MAX_XLAT_TABLES][XLAT_TABLE_ENTRIES]
 __aligned(0x1000);
 
+/* Pool the translation tables are allocated from, see mmu_set_xlat_tables() */
+static u64 (*xlat_tables)[XLAT_TABLE_ENTRIES] = prealloc_xlat_tables;
+static unsigned int xlat_tables_nr = CONFIG_MAX_XLAT_TABLES;
+static unsigned int xlat_tables_used;
+
 /* Translation table control register settings */
 static u64 get_tcr(int el)
 {
@@ -94,14 +101,28 @@ static u64 *calculate_pte_index(u64 addr, int level)
 
 static void set_pte_table_desc(u64 *pte, u64 *table, unsigned int level)
 {
-#if DUMP_PTE
-	printf("%s", XLAT_TABLE_LEVEL_SPACE(level));
-	printf("%p: [Table] %p\n", pte, table);
-#endif
+	mmu_log(LOG_TRACE, "%s%p: [Table] %p\n",
+		XLAT_TABLE_LEVEL_SPACE(level), pte, table);
 	/* Point pte to new table */
 	*pte = PTE_TABLE_DESC | (u64)table;
 }
 
+static void __attribute__((noinline, cold))
+dump_pte_block_desc(u64 *pte, unsigned int mem_type, unsigned int attrs,
+		    unsigned int level)
+{
+	printf(" %s", XLAT_TABLE_LEVEL_SPACE(level));
+	printf("%p: ", pte);
+	printf((mem_type == MT_NORMAL) ?
+			  "MEM" :
+			  ((mem_type == MT_NORMAL_NC) ? "NC" :
+			  ((mem_type == MT_NORMAL_WT) ? "WT" : "DEV")));
+	printf((attrs & MT_RW) ? "-RW" : "-RO");
+	printf((attrs & MT_NS) ? "-NS" : "-S");
+	printf((attrs & MT_P_EXECUTE_NEVER) ? "-XN" : "-EXEC");
+	printf("\n");
+}
+
 static void set_pte_block_desc(u64 *pte, u64 addr_pa, unsigned int attrs,
 			       unsigned int level)
 {
@@ -138,42 +159,64 @@ static void set_pte_block_desc(u64 *pte, u64 addr_pa, unsigned int attrs,
 		desc |= PTE_BLOCK_DESC_UXN;
 		break;
 	case MT_NORMAL_NC:
+	case MT_NORMAL_WT:
 	case MT_NORMAL:
 		/* Make Normal RW memory as execute never */
 		/* if ((attrs & MT_RW) || (attrs & MT_EXECUTE_NEVER)) {
 			desc |= PTE_BLOCK_DESC_PXN;
 			desc |= PTE_BLOCK_DESC_UXN;
 		} */
-		if (mem_type == MT_NORMAL)
+		if (mem_type != MT_NORMAL_NC)
 			desc |= PTE_BLOCK_DESC_INNER_SHARE;
 		else
 			desc |= PTE_BLOCK_DESC_OUTER_SHARE;
 	}
 
-#if DUMP_PTE
-	printf(" %s", XLAT_TABLE_LEVEL_SPACE(level));
-	printf("%p: ", pte);
-	printf((mem_type == MT_NORMAL) ?
-			  "MEM" :
-			  ((mem_type == MT_NORMAL_NC) ? "NC" : "DEV"));
-	printf((attrs & MT_RW) ? "-RW" : "-RO");
-	printf((attrs & MT_NS) ? "-NS" : "-S");
-	printf((attrs & MT_P_EXECUTE_NEVER) ? "-XN" : "-EXEC");
-	printf("\n");
-#endif
+	if (log_enabled(LOG_MMU, LOG_TRACE))
+		dump_pte_block_desc(pte, mem_type, attrs, level);
 
 	*pte = desc;
 }
 
-/* Returns a new reallocated table */
+/* Returns a new zeroed table, or NULL once the pool is used up */
 static u64 *new_prealloc_table(void)
 {
-	static unsigned int table_idx;
-	return (u64 *)(xlat_tables[table_idx++]);
+	u64 *table;
+
+	if (xlat_tables_used == xlat_tables_nr) {
+		printf("mmu: out of translation tables (%u)\n", xlat_tables_nr);
+		return NULL;
+	}
+
+	table = xlat_tables[xlat_tables_used++];
+	memset(table, 0, sizeof(xlat_tables[0]));
+	return table;
+}
+
+/*
+ * Allocate translation tables from "tables" from now on and start over with
+ * an empty base table. Only for use before enable_mmu(), the host tests use
+ * it to run add_map() on memory of their own.
+ */
+void mmu_set_xlat_tables(u64 (*tables)[XLAT_TABLE_ENTRIES], unsigned int nr)
+{
+	xlat_tables = tables;
+	xlat_tables_nr = nr;
+	xlat_tables_used = 0;
+	memset(base_xlat_table, 0, sizeof(base_xlat_table));
+}
+
+/* The base translation table, what TTBR0_EL2 points to */
+u64 *mmu_base_xlat_table(void)
+{
+	return base_xlat_table;
 }
 
-/* Splits a block into table with entries spanning the old block */
-static void split_pte_block_desc(u64 *pte, int level)
+/*
+ * Splits a block into table with entries spanning the old block.
+ * Returns -1 if no table is left.
+ */
+static int split_pte_block_desc(u64 *pte, int level)
 {
 	u64 old_block_desc = *pte;
 	u64 *new_table;
@@ -181,9 +224,11 @@ static void split_pte_block_desc(u64 *pte, int level)
 	/* get address size shift bits for next level */
 	int levelshift = LEVEL_TO_VA_SIZE_SHIFT(level + 1);
 
-	printf("Splitting existing PTE %p(L%d)\n", pte, level);
+	mmu_log(LOG_DEBUG, "Splitting existing PTE %p(L%d)\n", pte, level);
 
 	new_table = new_prealloc_table();
+	if (!new_table)
+		return -1;
 
 	for (i = 0; i < XLAT_TABLE_ENTRIES; i++) {
 		new_table[i] = old_block_desc | (i << levelshift);
@@ -194,6 +239,7 @@ static void split_pte_block_desc(u64 *pte, int level)
 
 	/* Overwrite existing PTE set the new table into effect */
 	set_pte_table_desc(pte, new_table, level);
+	return 0;
 }
 
 /* Create/Populate translation table(s) for given region */
@@ -206,7 +252,7 @@ void add_map(const char *name,
 	u64 *new_table;
 	unsigned int level = XLAT_TABLE_BASE_LEVEL;
 
-	printf("mmap: virt %llx phys %llx size %llx\n", virt, phys, size);
+	mmu_log(LOG_DEBUG, "mmap: virt %lx phys %lx size %x\n", virt, phys, size);
 
 	while (size) {
 		/* Locate PTE for given virtual address and page table level */
@@ -214,7 +260,7 @@ void add_map(const char *name,
 
 		level_size = 1ULL << LEVEL_TO_VA_SIZE_SHIFT(level);
 
-		if (size >= level_size && !(virt & (level_size - 1))) {
+		if (size >= level_size && !((virt | phys) & (level_size - 1))) {
 			/* Given range fits into level size,
 			 * create block/page descriptor
 			 */
@@ -227,47 +273,105 @@ void add_map(const char *name,
 		} else if (pte_desc_type(pte) == PTE_INVALID_DESC) {
 			/* Range doesn't fit, create subtable */
 			new_table = new_prealloc_table();
+			if (!new_table)
+				goto out_of_tables;
 			set_pte_table_desc(pte, new_table, level);
 			level++;
 		} else if (pte_desc_type(pte) == PTE_BLOCK_DESC) {
-			split_pte_block_desc(pte, level);
+			if (split_pte_block_desc(pte, level))
+				goto out_of_tables;
 			level++;
 		} else if (pte_desc_type(pte) == PTE_TABLE_DESC) {
 			level++;
 		}
 	}
+	return;
+
+out_of_tables:
+	printf("mmap: %s left unmapped from virt %lx\n", name, virt);
+}
+
+/* Hand out device mappings from the ioremap window */
+void *ioremap(unsigned long phys, size_t size, unsigned int type)
+{
+	static unsigned long next_va = CONFIG_IOREMAP_BASE;
+	unsigned long offset = phys & (CONFIG_MMU_PAGE_SIZE - 1);
+	unsigned long align = CONFIG_MMU_PAGE_SIZE;
+	unsigned long va;
+
+	switch (type) {
+	case MT_DEVICE_nGnRnE:
+	case MT_DEVICE_nGnRE:
+	case MT_DEVICE_GRE:
+	case MT_NORMAL_NC:
+		break;
+	default:
+		printf("ioremap: bad memory type %u\n", type);
+		return NULL;
+	}
+
+	phys -= offset;
+	size = (size + offset + CONFIG_MMU_PAGE_SIZE - 1) &
+	       ~(CONFIG_MMU_PAGE_SIZE - 1);
+
+	/* Keep large regions 2MB aligned so they can use block descriptors */
+	if (size >= SZ_2M && !(phys & (SZ_2M - 1)))
+		align = SZ_2M;
+
+	va = (next_va + align - 1) & ~(align - 1);
+	if (va + size > CONFIG_IOREMAP_BASE + CONFIG_IOREMAP_SIZE) {
+		printf("ioremap: window exhausted mapping %lx\n", phys);
+		return NULL;
+	}
+	next_va = va + size;
+
+	add_map("ioremap", phys, va, size,
+		type | MT_RW | MT_NS | MT_P_EXECUTE_NEVER | MT_U_EXECUTE_NEVER);
+
+	/*
+	 * Only invalid entries were filled, so no TLB maintenance is needed;
+	 * make the new entries visible to the walker before first use.
+	 */
+	dsbishst();
+	isb();
+
+	return (void *)(va + offset);
 }
 
 void enable_mmu()
 {
 	u64 val;
+	u64 start, ticks;
 
 	/* Set MAIR, TCR and TBBR registers */
-	__asm__ volatile("msr mair_el2, %0"
-			 :
-			 : "r"(MEMORY_ATTRIBUTES)
-			 : "memory", "cc");
-	__asm__ volatile("msr tcr_el2, %0"
-			 :
-			 : "r"(get_tcr(2))
-			 : "memory", "cc");
-	__asm__ volatile("msr ttbr0_el2, %0"
-			 :
-			 : "r"((u64)base_xlat_table)
-			 : "memory", "cc");
+	write_mair_el2(MEMORY_ATTRIBUTES);
+	write_tcr_el2(get_tcr(2));
+	write_ttbr0_el2((u64)base_xlat_table);
+
+	/*
+	 * Nothing may be left in the data cache that would shadow the tables
+	 * and data written with the MMU off. Invalidate only: every access so
+	 * far was non-cacheable, so any dirty line is stale, from before reset
+	 * or firmware, and cleaning it would write it back over them.
+	 */
+	isb();
+	start = read_msr(cntpct_el0);
+	dcsw_op_all(DCISW);
+	isb();
+	ticks = read_msr(cntpct_el0) - start;
 
 	/* Ensure these changes are seen before MMU is enabled */
 	isb();
 
 	/* Enable the MMU and data cache */
-	__asm__ volatile("mrs %0, sctlr_el2" : "=r"(val));
-	__asm__ volatile("msr sctlr_el2, %0"
-			 :
-			 : "r"(val | SCTLR_M | SCTLR_C)
-			 : "memory", "cc");
+	val = read_sctlr_el2();
+	write_sctlr_el2(val | SCTLR_M | SCTLR_C);
 
 	/* Ensure the MMU enable takes effect immediately */
 	isb();
 
-	printf("MMU enabled with dcache\n");
+	mmu_log(LOG_INFO, "MMU enabled with dcache\n");
+	mmu_log(LOG_INFO,
+		"dcache invalidate by set/way: %llu ticks (%llu ns)\n",
+		ticks, ticks * 1000000000ULL / read_cntfrq_el0());
 }
@@ -0,0 +1,177 @@
+#include <arch_help.h>
+#include <barrier.h>
+#include <console.h>
+#include <debug.h>
+#include <types.h>
+
+static char console_ring[CONSOLE_RING_SIZE];
+/*
+ * Free running, the ring holds console_ring[tail..head) modulo its size
+ * still to be sent, and [done..tail) handed to a zero-copy output that
+ * has not given it back yet. done is tail for every other output.
+ */
+static unsigned int console_head;
+static unsigned int console_tail;
+static unsigned int console_done;
+/* the UART transmit interrupt drains the ring, see console_irq_init() */
+static int console_irq;
+/* where console_drain() sends the ring, the PL011 unless changed */
+static unsigned int (*console_output)(const char *buf, unsigned int len) =
+	uart_write_fifo;
+/* zero-copy outputs only: calls console_release() for finished buffers */
+static void (*console_reclaim)(void);
+
+#define RING_MASK	(CONSOLE_RING_SIZE - 1)
+
+/*
+ * Runs in thread context and from the UART transmit interrupt, so the
+ * tail only moves with IRQs masked.
+ */
+void console_drain(void)
+{
+	u64 flags = local_irq_save();
+
+	if (console_reclaim)
+		console_reclaim();
+
+	while (console_tail != console_head) {
+		unsigned int off = console_tail & RING_MASK;
+		unsigned int len = console_head - console_tail;
+		unsigned int n;
+
+		/* up to the end of the buffer, the rest on the next pass */
+		if (len > CONSOLE_RING_SIZE - off)
+			len = CONSOLE_RING_SIZE - off;
+
+		n = console_output(console_ring + off, len);
+		console_tail += n;
+		if (n < len)
+			break;	/* FIFO full */
+	}
+	if (!console_reclaim)
+		console_done = console_tail;
+
+	/* refill from the interrupt once the FIFO has drained */
+	if (console_irq)
+		uart_tx_irq(console_tail != console_head);
+	local_irq_restore(flags);
+}
+
+/*
+ * Full ring: the caller has to wait for the UART after all. With the
+ * transmit interrupt on it sleeps until the interrupt made room; WFI
+ * with IRQs masked still wakes up for the pending interrupt, which is
+ * taken once they are unmasked again.
+ */
+static void console_make_room(void)
+{
+	while (console_head - console_done == CONSOLE_RING_SIZE) {
+		u64 flags;
+
+		console_drain();
+		if (!console_irq)
+			continue;
+		flags = local_irq_save();
+		if (console_head - console_done == CONSOLE_RING_SIZE)
+			wfi();
+		local_irq_restore(flags);
+	}
+}
+
+/*
+ * The transmit interrupt reads console_head: the bytes have to be in the
+ * ring before the new head is, hence the barrier() between them.
+ */
+void console_putc(int c)
+{
+	console_make_room();
+	console_ring[console_head & RING_MASK] = c;
+	barrier();
+	console_head++;
+}
+
+/*
+ * Copied a byte at a time: this runs before the MMU is on too, where all
+ * of memory is Device memory and an unaligned memcpy() would fault.
+ */
+void console_queue(const char *buf, size_t len)
+{
+	while (len) {
+		unsigned int head = console_head;
+		unsigned int room;
+
+		console_make_room();
+		room = CONSOLE_RING_SIZE - (head - console_done);
+		for (; room && len; room--, len--)
+			console_ring[head++ & RING_MASK] = *buf++;
+		barrier();
+		console_head = head;
+	}
+}
+
+void console_write(const char *buf, size_t len)
+{
+	console_queue(buf, len);
+	console_drain();
+}
+
+int console_flush(void)
+{
+	while (console_done != console_head)
+		console_drain();
+	uart_wait_idle();
+	return 0;
+}
+
+void console_irq_init(void)
+{
+	uart_irq_init(console_drain);
+	/* receive still works on interrupts with the output elsewhere */
+	console_irq = console_output == uart_write_fifo;
+}
+
+static void console_switch_output(unsigned int (*write)(const char *buf,
+							  unsigned int len),
+				  void (*reclaim)(void))
+{
+	u64 flags;
+
+	console_flush();
+	flags = local_irq_save();
+	if (console_irq)
+		uart_tx_irq(0);
+	console_irq = 0;
+	console_output = write;
+	console_reclaim = reclaim;
+	local_irq_restore(flags);
+}
+
+/*
+ * Send the output somewhere else than the PL011, from here on. write
+ * takes what it can and returns how much that was, like
+ * uart_write_fifo(). The UART transmit interrupt is no longer used.
+ */
+void console_set_output(unsigned int (*write)(const char *buf,
+					      unsigned int len))
+{
+	console_switch_output(write, NULL);
+}
+
+/*
+ * The same for an output that keeps pointing into the ring after write
+ * returned, such as a DMA descriptor. Those bytes are not reused until
+ * the output gives them back with console_release(), from reclaim,
+ * which console_drain() calls first. Buffers have to be released in the
+ * order they were written.
+ */
+void console_set_output_zerocopy(unsigned int (*write)(const char *buf,
+						       unsigned int len),
+				 void (*reclaim)(void))
+{
+	console_switch_output(write, reclaim);
+}
+
+void console_release(unsigned int len)
+{
+	console_done += len;
+}
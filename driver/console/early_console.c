@@ -0,0 +1,27 @@
+/*
+ * Replay of the early console into the log
+ */
+#include <early_console.h>
+#include <log.h>
+#include <string.h>
+
+/*
+ * The messages stay where uart_print() put them, the log records point
+ * at their text, so they are formatted when the log is drained.
+ */
+void early_console_replay(void)
+{
+	u64 pos = 0;
+
+	while (pos < early_console_pos) {
+		u64 stamp = *(u64 *)(early_console_buf + pos);
+		const char *text = early_console_buf + pos + 8;
+
+		log_fast_at(stamp, "early: %s", text);
+		pos = (pos + 8 + strlen(text) + 1 + 7) & ~7ULL;
+	}
+
+	if (early_console_lost)
+		log_fast("early: %llu messages did not fit\n",
+			 early_console_lost);
+}
@@ -0,0 +1,109 @@
+/*
+ * GICv3 distributor, redistributor and CPU interface of the boot CPU
+ */
+#include <arch_help.h>
+#include <cpu.h>
+#include <gic.h>
+#include <io.h>
+#include <mmu.h>
+#include <sizes.h>
+#include <stdio.h>
+
+static uintptr_t gicd;
+static uintptr_t gicr;		/* RD_base of this CPU */
+
+static void gicd_wait_rwp(void)
+{
+	while (read_32(gicd + GICD_CTLR) & GICD_CTLR_RWP)
+		;
+}
+
+/* MPIDR_EL1 affinity in the Aff3.Aff2.Aff1.Aff0 layout of GICR_TYPER */
+static u32 gic_cpu_affinity(void)
+{
+	u64 mpidr = read_mpidr_el1();
+
+	return ((mpidr >> 8) & 0xff000000) | (mpidr & 0xffffff);
+}
+
+static uintptr_t gicr_find(uintptr_t base)
+{
+	u32 aff = gic_cpu_affinity();
+	u64 typer;
+
+	do {
+		typer = read_64(base + GICR_TYPER);
+		if ((typer >> GICR_TYPER_AFF_SHIFT) == aff)
+			return base;
+		base += GICR_STRIDE;
+	} while (!(typer & GICR_TYPER_LAST));
+
+	return 0;
+}
+
+void gic_init(void)
+{
+	gicd = (uintptr_t)ioremap(GICD_BASE, SZ_64K, MT_DEVICE_nGnRE);
+	gicr = (uintptr_t)ioremap(GICR_BASE, NR_CPUS * GICR_STRIDE,
+				  MT_DEVICE_nGnRE);
+	if (!gicd || !gicr)
+		return;
+	gicr = gicr_find(gicr);
+	if (!gicr) {
+		printf("gic: no redistributor for this cpu\n");
+		return;
+	}
+
+	/* Distributor: affinity routing, Group 1 */
+	write_32(gicd + GICD_CTLR, 0);
+	gicd_wait_rwp();
+	write_32(gicd + GICD_CTLR, GICD_CTLR_ARE | GICD_CTLR_ENABLE_G1);
+	gicd_wait_rwp();
+
+	/* Wake up the redistributor */
+	clrbits_32(gicr + GICR_WAKER, GICR_WAKER_PS);
+	while (read_32(gicr + GICR_WAKER) & GICR_WAKER_CA)
+		;
+
+	/* CPU interface: system registers, all priorities, Group 1 on */
+	write_icc_sre_el2(read_icc_sre_el2() | ICC_SRE_SRE | ICC_SRE_ENABLE);
+	isb();
+	write_icc_pmr_el1(0xff);
+	write_icc_bpr1_el1(0);
+	write_icc_igrpen1_el1(1);
+
+	/* Physical IRQs are taken to EL2 */
+	write_hcr_el2(read_hcr_el2() | HCR_IMO);
+	isb();
+}
+
+void gic_enable_irq(unsigned int irq)
+{
+	u32 bit = 1U << (irq % 32);
+
+	if (irq < 32) {
+		uintptr_t sgi = gicr + GICR_SGI_OFFSET;
+
+		setbits_32(sgi + GICR_IGROUPR0, bit);
+		write_8(sgi + GICR_IPRIORITYR(irq), GIC_PRIO_DEFAULT);
+		write_32(sgi + GICR_ISENABLER0, bit);
+		return;
+	}
+
+	setbits_32(gicd + GICD_IGROUPR(irq / 32), bit);
+	write_8(gicd + GICD_IPRIORITYR(irq), GIC_PRIO_DEFAULT);
+	/* level sensitive */
+	clrbits_32(gicd + GICD_ICFGR(irq / 16), 2U << (irq % 16 * 2));
+	write_64(gicd + GICD_IROUTER(irq), read_mpidr_el1() & 0xff00ffffffUL);
+	write_32(gicd + GICD_ISENABLER(irq / 32), bit);
+}
+
+unsigned int gic_ack_irq(void)
+{
+	return read_icc_iar1_el1() & 0xffffff;
+}
+
+void gic_eoi_irq(unsigned int irq)
+{
+	write_icc_eoir1_el1(irq);
+}
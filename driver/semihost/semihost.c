@@ -0,0 +1,78 @@
+/*
+ * Semihosting calls, see include/semihost.h
+ */
+#include <semihost.h>
+#include <string.h>
+
+static int semihost_ok;
+static int semihost_stdout = -1;
+
+static long semihost_call(unsigned long op, void *param)
+{
+	register unsigned long x0 asm("x0") = op;
+	register void *x1 asm("x1") = param;
+
+	asm volatile("hlt	#0xf000"
+		     : "+r"(x0) : "r"(x1) : "memory");
+	return x0;
+}
+
+int semihost_open(const char *name, int mode)
+{
+	unsigned long param[3] = {
+		(unsigned long)name, mode, strlen(name)
+	};
+
+	return semihost_call(SYS_OPEN, param);
+}
+
+int semihost_close(int fd)
+{
+	unsigned long param[1] = { fd };
+
+	return semihost_call(SYS_CLOSE, param);
+}
+
+/* SYS_WRITE returns the number of bytes it did not write */
+int semihost_write(int fd, const void *buf, size_t len)
+{
+	unsigned long param[3] = {
+		fd, (unsigned long)buf, len
+	};
+
+	return semihost_call(SYS_WRITE, param) ? -1 : 0;
+}
+
+int semihost_init(void)
+{
+	/* ":tt" is the host's console, opened for writing its stdout */
+	semihost_stdout = semihost_open(":tt", SEMIHOST_OPEN_W);
+	semihost_ok = semihost_stdout != -1;
+	return semihost_ok ? 0 : -1;
+}
+
+int semihost_available(void)
+{
+	return semihost_ok;
+}
+
+unsigned int semihost_console_write(const char *buf, unsigned int len)
+{
+	semihost_write(semihost_stdout, buf, len);
+	return len;
+}
+
+int semihost_dump(const char *name, const void *buf, size_t len)
+{
+	int fd, ret;
+
+	if (!semihost_ok)
+		return -1;
+
+	fd = semihost_open(name, SEMIHOST_OPEN_WB);
+	if (fd == -1)
+		return -1;
+	ret = semihost_write(fd, buf, len);
+	semihost_close(fd);
+	return ret;
+}
@@ -1,24 +1,161 @@
 #include "io.h"
-
-#define PL011_BASE     0x09000000
+#include <barrier.h>
+#include <debug.h>
+#include <irq.h>
+#include <pl011.h>
+#include <stddef.h>
 
 #define R_UART_TX      (PL011_BASE + 0x0)
+#define R_UART_DR      (PL011_BASE + UARTDR)
+#define R_UART_FR      (PL011_BASE + UARTFR)
+#define FR_TXFE        (1 << PL011_UARTFR_TXFE_BIT)
+#define FR_TXFF        (1 << PL011_UARTFR_TXFF_BIT)
+#define FR_BUSY        (1 << PL011_UARTFR_BUSY_BIT)
 #define R_UART_LCR     (PL011_BASE + 0x2c)
 #define LCR_DATA_LEN_8 (3 << 5)
 #define LCR_FIFO_EN    (1 << 4)
 #define R_UART_CR      (PL011_BASE + 0x30)
+#define R_UART_IFLS    (PL011_BASE + UARTIFLS)
+#define R_UART_IMSC    (PL011_BASE + UARTIMSC)
+#define R_UART_MIS     (PL011_BASE + UARTMIS)
+#define R_UART_ICR     (PL011_BASE + UARTICR)
+#define FR_RXFE        (1 << PL011_UARTFR_RXFE_BIT)
 #define CR_UART_EN     1
 #define CR_UART_TXE    (1 << 8)
 #define CR_UART_RXE    (1 << 9)
 
+#define UART_RX_RING_SIZE	1024	/* power of two */
+
+/* Filled by the RX interrupt, emptied by uart_getc(), both free running */
+static char uart_rx_ring[UART_RX_RING_SIZE];
+static u32 uart_rx_head;
+static u32 uart_rx_tail;
+static unsigned int uart_rx_lost;
+
+static void (*uart_tx_ready)(void);
+static u32 uart_imsc;		/* what UARTIMSC holds */
+
 int uart_putchar(int c)
 {
-	* (volatile unsigned int *) R_UART_TX = c;
+	while (read_32(R_UART_FR) & FR_TXFF)
+		;
+	write_32(R_UART_TX, c);
 	return c;
 }
 
+/*
+ * Write as much of buf as the transmit FIFO takes without waiting.
+ * An empty FIFO is filled in one burst without looking at the flags
+ * again, after that every byte checks TXFF. Returns the bytes written.
+ */
+unsigned int uart_write_fifo(const char *buf, unsigned int len)
+{
+	unsigned int n = 0;
+
+	if (read_32(R_UART_FR) & FR_TXFE) {
+		unsigned int burst = len < PL011_TX_FIFO_DEPTH ?
+				     len : PL011_TX_FIFO_DEPTH;
+
+		for (; n < burst; n++)
+			write_32(R_UART_TX, (unsigned char)buf[n]);
+	}
+
+	while (n < len && !(read_32(R_UART_FR) & FR_TXFF))
+		write_32(R_UART_TX, (unsigned char)buf[n++]);
+
+	return n;
+}
+
+/* Wait until the FIFO is empty and the last stop bit has left */
+void uart_wait_idle(void)
+{
+	while (read_32(R_UART_FR) & FR_BUSY)
+		;
+}
+
 void uart_init(void)
 {
 	write_32(R_UART_LCR, LCR_DATA_LEN_8 | LCR_FIFO_EN);
 	write_32(R_UART_CR, CR_UART_RXE | CR_UART_TXE | CR_UART_EN);
 }
+
+/* Move everything in the receive FIFO to the ring */
+static void uart_rx_fill(void)
+{
+	u32 head = uart_rx_head;
+
+	while (!(read_32(R_UART_FR) & FR_RXFE)) {
+		char c = read_32(R_UART_DR);
+
+		if (head - smp_load_acquire_32(&uart_rx_tail) ==
+		    UART_RX_RING_SIZE) {
+			uart_rx_lost++;
+			continue;
+		}
+		uart_rx_ring[head++ & (UART_RX_RING_SIZE - 1)] = c;
+	}
+	smp_store_release_32(&uart_rx_head, head);
+}
+
+static void uart_irq(unsigned int irq, void *data)
+{
+	u32 mis = read_32(R_UART_MIS);
+
+	if (mis & (PL011_INT_RX | PL011_INT_RT))
+		uart_rx_fill();
+	if (mis & PL011_INT_ERR)
+		write_32(R_UART_ICR, PL011_INT_ERR);
+	if (mis & PL011_INT_TX) {
+		/* the FIFO has room again, cleared before it is refilled */
+		write_32(R_UART_ICR, PL011_INT_TX);
+		uart_tx_ready();
+	}
+}
+
+/*
+ * Receive and transmit on interrupts. The receive FIFO is emptied into a
+ * ring when it is half full or has been idle for 32 bit periods, so
+ * input is not lost while the CPU is busy elsewhere. tx_ready is called
+ * from the interrupt each time the transmit FIFO drains to a quarter,
+ * while uart_tx_irq() has that interrupt enabled.
+ */
+void uart_irq_init(void (*tx_ready)(void))
+{
+	uart_tx_ready = tx_ready;
+	write_32(R_UART_IFLS, PL011_UARTIFLS_TX_1_4 | PL011_UARTIFLS_RX_1_2);
+	write_32(R_UART_ICR, PL011_INT_ALL);
+	uart_imsc = PL011_INT_RX | PL011_INT_RT | PL011_INT_ERR;
+	write_32(R_UART_IMSC, uart_imsc);
+	irq_register(PL011_IRQ, uart_irq, NULL);
+}
+
+/* Enable the transmit interrupt while there is output left, IRQs masked */
+void uart_tx_irq(int enable)
+{
+	u32 imsc = enable ? uart_imsc | PL011_INT_TX :
+			    uart_imsc & ~PL011_INT_TX;
+
+	if (imsc != uart_imsc) {
+		uart_imsc = imsc;
+		write_32(R_UART_IMSC, imsc);
+	}
+}
+
+/* Characters that arrived while the ring was full */
+unsigned int uart_rx_dropped(void)
+{
+	return uart_rx_lost;
+}
+
+/* Next received character, -1 if there is none */
+int uart_getc(void)
+{
+	u32 tail = uart_rx_tail;
+	unsigned char c;
+
+	if (tail == smp_load_acquire_32(&uart_rx_head))
+		return -1;
+	c = uart_rx_ring[tail & (UART_RX_RING_SIZE - 1)];
+	smp_store_release_32(&uart_rx_tail, tail + 1);
+	return c;
+}
@@ -0,0 +1,65 @@
+/*
+ * virtio-console output
+ *
+ * Run QEMU with a console on the virtio-serial bus, e.g.
+ *
+ *   ./qemu.sh -device virtio-serial-device \
+ *	-chardev file,id=vcon,path=console.log \
+ *	-device virtconsole,chardev=vcon
+ *
+ * The console ring is sent without copying: console_drain() hands all
+ * that is pending over as one descriptor pointing into the ring, two when
+ * it wraps around, so everything printed since the last drain goes out
+ * with a single notification instead of an exit per byte on the PL011.
+ * The device completes the buffers in order and reclaim gives their
+ * bytes back to the ring.
+ *
+ * Without VIRTIO_CONSOLE_F_MULTIPORT there is the one port, queue 0
+ * receives and queue 1 transmits. The device interrupt stays off, the
+ * used ring is polled from console_drain().
+ */
+#include <console.h>
+#include <stdio.h>
+#include <virtio.h>
+
+#define VIRTIO_CONSOLE_TXQ	1
+
+static struct virtq virtio_console_txq;
+
+static void virtio_console_reclaim(void)
+{
+	u32 len;
+
+	while (virtq_get_used(&virtio_console_txq, &len) >= 0)
+		console_release(len);
+}
+
+static unsigned int virtio_console_write(const char *buf, unsigned int len)
+{
+	struct virtq *vq = &virtio_console_txq;
+
+	if (!vq->num_free)
+		virtio_console_reclaim();
+	if (virtq_add_buf(vq, buf, len, 1) < 0)
+		return 0;
+	virtq_kick(vq);
+	return len;
+}
+
+int virtio_console_init(void)
+{
+	uintptr_t base = virtio_mmio_find(VIRTIO_ID_CONSOLE);
+
+	if (!base || virtio_mmio_setup(base, 0))
+		return -1;
+	if (virtq_init(&virtio_console_txq, base, VIRTIO_CONSOLE_TXQ)) {
+		printf("virtio-console: no transmit queue\n");
+		return -1;
+	}
+	virtio_console_txq.avail->flags = VIRTQ_AVAIL_F_NO_INTERRUPT;
+	virtio_mmio_driver_ok(base);
+
+	console_set_output_zerocopy(virtio_console_write,
+				    virtio_console_reclaim);
+	return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * virtio-mmio transport and split virtqueues, see include/virtio.h
+ */
+#include <barrier.h>
+#include <io.h>
+#include <mmu.h>
+#include <stdio.h>
+#include <virtio.h>
+
+#define VIRTQ_NUM		64	/* descriptors per queue, at most */
+#define VIRTQ_MAX_QUEUES	2
+/* descriptors and avail ring in the first page, the used ring in the next */
+#define VIRTQ_SIZE		(2 * VIRTQ_ALIGN)
+
+static u8 virtq_pool[VIRTQ_MAX_QUEUES][VIRTQ_SIZE]
+	__attribute__((aligned(VIRTQ_ALIGN)));
+static unsigned int virtq_pool_used;
+
+static uintptr_t virtio_mmio;
+
+uintptr_t virtio_mmio_find(unsigned int id)
+{
+	unsigned int i;
+
+	if (!virtio_mmio)
+		virtio_mmio = (uintptr_t)ioremap(VIRTIO_MMIO_BASE,
+				VIRTIO_MMIO_NR_SLOTS * VIRTIO_MMIO_SLOT_SIZE,
+				MT_DEVICE_nGnRE);
+	if (!virtio_mmio)
+		return 0;
+
+	for (i = 0; i < VIRTIO_MMIO_NR_SLOTS; i++) {
+		uintptr_t base = virtio_mmio + i * VIRTIO_MMIO_SLOT_SIZE;
+
+		if (read_32(base + VIRTIO_MMIO_MAGIC) != VIRTIO_MMIO_MAGIC_VALUE)
+			continue;
+		if (read_32(base + VIRTIO_MMIO_DEVICE_ID) == id)
+			return base;
+	}
+	return 0;
+}
+
+static int virtio_mmio_legacy(uintptr_t base)
+{
+	return read_32(base + VIRTIO_MMIO_VERSION) == 1;
+}
+
+static u64 virtio_mmio_features(uintptr_t base)
+{
+	u64 features;
+
+	write_32(base + VIRTIO_MMIO_DEVICE_FEATURES_SEL, 1);
+	features = (u64)read_32(base + VIRTIO_MMIO_DEVICE_FEATURES) << 32;
+	write_32(base + VIRTIO_MMIO_DEVICE_FEATURES_SEL, 0);
+	return features | read_32(base + VIRTIO_MMIO_DEVICE_FEATURES);
+}
+
+int virtio_mmio_setup(uintptr_t base, u64 want)
+{
+	int legacy = virtio_mmio_legacy(base);
+	u64 features;
+
+	write_32(base + VIRTIO_MMIO_STATUS, 0);
+	setbits_32(base + VIRTIO_MMIO_STATUS, VIRTIO_STATUS_ACKNOWLEDGE);
+	setbits_32(base + VIRTIO_MMIO_STATUS, VIRTIO_STATUS_DRIVER);
+
+	if (!legacy)
+		want |= 1ULL << VIRTIO_F_VERSION_1;
+	features = virtio_mmio_features(base) & want;
+	write_32(base + VIRTIO_MMIO_DRIVER_FEATURES_SEL, 1);
+	write_32(base + VIRTIO_MMIO_DRIVER_FEATURES, features >> 32);
+	write_32(base + VIRTIO_MMIO_DRIVER_FEATURES_SEL, 0);
+	write_32(base + VIRTIO_MMIO_DRIVER_FEATURES, features);
+
+	/* legacy devices have no FEATURES_OK handshake */
+	if (legacy)
+		return 0;
+	setbits_32(base + VIRTIO_MMIO_STATUS, VIRTIO_STATUS_FEATURES_OK);
+	if (!(read_32(base + VIRTIO_MMIO_STATUS) & VIRTIO_STATUS_FEATURES_OK) ||
+	    !(features & (1ULL << VIRTIO_F_VERSION_1))) {
+		setbits_32(base + VIRTIO_MMIO_STATUS, VIRTIO_STATUS_FAILED);
+		return -1;
+	}
+	return 0;
+}
+
+void virtio_mmio_driver_ok(uintptr_t base)
+{
+	setbits_32(base + VIRTIO_MMIO_STATUS, VIRTIO_STATUS_DRIVER_OK);
+}
+
+static void write_addr(uintptr_t reg, const void *p)
+{
+	u64 addr = (uintptr_t)p;
+
+	write_32(reg, addr);
+	write_32(reg + 4, addr >> 32);
+}
+
+int virtq_init(struct virtq *vq, uintptr_t base, unsigned int index)
+{
+	unsigned int num, i;
+	u8 *mem;
+
+	if (virtq_pool_used == VIRTQ_MAX_QUEUES)
+		return -1;
+
+	write_32(base + VIRTIO_MMIO_QUEUE_SEL, index);
+	num = read_32(base + VIRTIO_MMIO_QUEUE_NUM_MAX);
+	if (!num)
+		return -1;
+	if (num > VIRTQ_NUM)
+		num = VIRTQ_NUM;
+
+	/* zeroed .bss: empty rings, no flags */
+	mem = virtq_pool[virtq_pool_used++];
+	vq->base = base;
+	vq->index = index;
+	vq->num = num;
+	vq->desc = (struct virtq_desc *)mem;
+	vq->avail = (struct virtq_avail *)(mem + num * sizeof(*vq->desc));
+	vq->used = (struct virtq_used *)(mem + VIRTQ_ALIGN);
+	vq->free_head = 0;
+	vq->num_free = num;
+	vq->avail_idx = 0;
+	vq->last_used = 0;
+	for (i = 0; i < num - 1; i++)
+		vq->desc[i].next = i + 1;
+
+	write_32(base + VIRTIO_MMIO_QUEUE_NUM, num);
+	if (virtio_mmio_legacy(base)) {
+		write_32(base + VIRTIO_MMIO_GUEST_PAGE_SIZE, VIRTQ_ALIGN);
+		write_32(base + VIRTIO_MMIO_QUEUE_ALIGN, VIRTQ_ALIGN);
+		write_32(base + VIRTIO_MMIO_QUEUE_PFN,
+			 (uintptr_t)mem / VIRTQ_ALIGN);
+	} else {
+		write_addr(base + VIRTIO_MMIO_QUEUE_DESC_LOW, vq->desc);
+		write_addr(base + VIRTIO_MMIO_QUEUE_AVAIL_LOW, vq->avail);
+		write_addr(base + VIRTIO_MMIO_QUEUE_USED_LOW,
+			   (const void *)vq->used);
+		write_32(base + VIRTIO_MMIO_QUEUE_READY, 1);
+	}
+	return 0;
+}
+
+int virtq_add_buf(struct virtq *vq, const void *buf, u32 len, int out)
+{
+	struct virtq_desc *d;
+	u16 id;
+
+	if (!vq->num_free)
+		return -1;
+
+	id = vq->free_head;
+	d = &vq->desc[id];
+	vq->free_head = d->next;
+	vq->num_free--;
+
+	d->addr = (uintptr_t)buf;
+	d->len = len;
+	d->flags = out ? 0 : VIRTQ_DESC_F_WRITE;
+	vq->avail->ring[vq->avail_idx++ % vq->num] = id;
+	return id;
+}
+
+/*
+ * One notification for everything added since the last one, none at all
+ * while the device says it is still polling the queue.
+ */
+void virtq_kick(struct virtq *vq)
+{
+	/* descriptors and ring entries before the index that publishes them */
+	dma_wmb();
+	*(volatile u16 *)&vq->avail->idx = vq->avail_idx;
+	/* the index before reading the device's flags */
+	dma_mb();
+	if (!(vq->used->flags & VIRTQ_USED_F_NO_NOTIFY))
+		write_32(vq->base + VIRTIO_MMIO_QUEUE_NOTIFY, vq->index);
+}
+
+int virtq_get_used(struct virtq *vq, u32 *len)
+{
+	u16 id;
+
+	if (vq->last_used == vq->used->idx)
+		return -1;
+	/* the index before the entry it covers */
+	dma_rmb();
+	id = vq->used->ring[vq->last_used++ % vq->num].id;
+
+	*len = vq->desc[id].len;
+	vq->desc[id].next = vq->free_head;
+	vq->free_head = id;
+	vq->num_free++;
+	return id;
+}
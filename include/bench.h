@@ -0,0 +1,7 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+/* libc micro-benchmarks, only linked into the "make bench" image */
+void libc_bench(void);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __CONSOLE_H__
+#define __CONSOLE_H__
+
+#include <stddef.h>
+
+/*
+ * Buffered console on the PL011
+ *
+ * Output is appended to an in-memory ring and moved to the UART by
+ * console_drain(), as much as the transmit FIFO takes at that moment, so
+ * printing only waits for the UART once the ring is full. Anything that
+ * stops the CPU afterwards (panic, exception, end of main) has to call
+ * console_flush() first or the tail of the output is lost.
+ *
+ * The ring has a single producer and no lock: one CPU, and the only
+ * exception handlers that print are the fatal ones, which flush. After
+ * console_irq_init() the UART transmit interrupt keeps draining the ring
+ * in the background, console_drain() only starts it.
+ */
+
+#define CONSOLE_RING_SIZE	16384	/* power of two */
+
+/* Append to the ring, only touches the UART if the ring is full */
+void console_putc(int c);
+void console_queue(const char *buf, size_t len);
+
+/* Move what the transmit FIFO takes right now, without waiting */
+void console_drain(void);
+
+/* console_queue() followed by console_drain() */
+void console_write(const char *buf, size_t len);
+
+/* Drain the whole ring and wait until the UART is idle */
+int console_flush(void);
+
+/* Drain from the UART transmit interrupt, needs the GIC set up */
+void console_irq_init(void);
+
+/* Drain into write instead of the PL011, e.g. semihost_console_write() */
+void console_set_output(unsigned int (*write)(const char *buf,
+					      unsigned int len));
+
+/* Zero-copy outputs, see console.c */
+void console_set_output_zerocopy(unsigned int (*write)(const char *buf,
+						       unsigned int len),
+				 void (*reclaim)(void));
+void console_release(unsigned int len);
+
+#endif /* __CONSOLE_H__ */
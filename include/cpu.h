@@ -1,12 +1,22 @@
 #ifndef __CPU_H__
 #define __CPU_H__
 
+#define NR_CPUS                      8
+
 #ifndef __ASM__
+#include <msr.h>
+
 /* top level view of a cpu data */
 struct cpu {
 	int id;
 	void *stack;
 };
+
+/* Index of the running CPU, QEMU virt numbers its CPUs in MPIDR.Aff0 */
+static inline unsigned int cpu_id(void)
+{
+	return read_msr(mpidr_el1) & (NR_CPUS - 1);
+}
 #endif
 
 #define CPU_ID_OFFSET                0
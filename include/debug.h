@@ -4,5 +4,13 @@
 /* uart init */
 void uart_init(void);
 int uart_putchar(int c);
+unsigned int uart_write_fifo(const char *buf, unsigned int len);
+void uart_wait_idle(void);
+
+/* interrupt driven operation, see uart.c */
+void uart_irq_init(void (*tx_ready)(void));
+void uart_tx_irq(int enable);
+int uart_getc(void);
+unsigned int uart_rx_dropped(void);
 
 #endif
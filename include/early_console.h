@@ -0,0 +1,33 @@
+#ifndef __EARLY_CONSOLE_H__
+#define __EARLY_CONSOLE_H__
+
+/*
+ * Early console
+ *
+ * uart_print() works from the first instruction on: it writes one line
+ * to the PL011, waiting on TXFF for each byte, and keeps a copy in
+ * early_console_buf. That buffer is in a section of its own outside
+ * .bss, so zero_bss does not wipe what was printed before it ran.
+ *
+ * Each message is stored as a CNTVCT_EL0 stamp followed by its text,
+ * up to EARLY_CONSOLE_LINE_MAX bytes and NUL terminated, padded to 8
+ * bytes. Messages that do not fit any more are counted in
+ * early_console_lost. early_console_replay() adds them to the log with
+ * their original stamps.
+ */
+
+#define EARLY_CONSOLE_SIZE	4096
+#define EARLY_CONSOLE_LINE_MAX	256
+
+#ifndef __ASM__
+#include <types.h>
+
+extern char early_console_buf[EARLY_CONSOLE_SIZE];
+extern u64 early_console_pos;
+extern u64 early_console_lost;
+
+/* After enable_mmu(), the buffer is read through Normal memory */
+void early_console_replay(void);
+#endif
+
+#endif /* __EARLY_CONSOLE_H__ */
@@ -0,0 +1,57 @@
+#ifndef __GIC_H__
+#define __GIC_H__
+
+/*
+ * GICv3 on QEMU virt (-machine gic-version=3), single security state:
+ * every interrupt is Group 1 and signalled as IRQ to EL2.
+ */
+
+#define GICD_BASE		0x08000000
+#define GICR_BASE		0x080a0000
+#define GICR_STRIDE		0x20000		/* RD_base + SGI_base frames */
+#define GICR_SGI_OFFSET		0x10000
+
+/* Distributor */
+#define GICD_CTLR		0x0000
+#define GICD_IGROUPR(n)		(0x0080 + 4 * (n))
+#define GICD_ISENABLER(n)	(0x0100 + 4 * (n))
+#define GICD_IPRIORITYR(n)	(0x0400 + (n))
+#define GICD_ICFGR(n)		(0x0c00 + 4 * (n))
+#define GICD_IROUTER(n)		(0x6000 + 8 * (n))
+
+#define GICD_CTLR_ENABLE_G1	(1 << 1)
+#define GICD_CTLR_ARE		(1 << 4)
+#define GICD_CTLR_RWP		(1U << 31)
+
+/* Redistributor, RD_base frame */
+#define GICR_CTLR		0x0000
+#define GICR_TYPER		0x0008
+#define GICR_WAKER		0x0014
+
+#define GICR_TYPER_LAST		(1 << 4)
+#define GICR_TYPER_AFF_SHIFT	32
+#define GICR_WAKER_PS		(1 << 1)	/* ProcessorSleep */
+#define GICR_WAKER_CA		(1 << 2)	/* ChildrenAsleep */
+
+/* Redistributor, SGI_base frame: SGIs and PPIs */
+#define GICR_IGROUPR0		0x0080
+#define GICR_ISENABLER0		0x0100
+#define GICR_IPRIORITYR(n)	(0x0400 + (n))
+
+/* CPU interface */
+#define ICC_SRE_SRE		(1 << 0)
+#define ICC_SRE_ENABLE		(1 << 3)	/* EL1 may use ICC_SRE_EL1 */
+
+#define GIC_PRIO_DEFAULT	0xa0
+#define GIC_SPURIOUS_IRQ	1023
+
+#ifndef __ASM__
+void gic_init(void);
+void gic_enable_irq(unsigned int irq);
+
+/* Highest priority pending IRQ, GIC_SPURIOUS_IRQ if none */
+unsigned int gic_ack_irq(void);
+void gic_eoi_irq(unsigned int irq);
+#endif
+
+#endif /* __GIC_H__ */
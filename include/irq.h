@@ -0,0 +1,22 @@
+#ifndef __IRQ_H__
+#define __IRQ_H__
+
+/*
+ * Interrupt handling at EL2
+ *
+ * The IRQ vector saves the caller-saved registers and calls do_irq(),
+ * which acknowledges interrupts at the GIC and runs their handlers until
+ * none is pending. Handlers run with IRQs masked and must not print
+ * through the console, they can use log_fast().
+ */
+
+#define NR_IRQS		128	/* SGIs, PPIs and the SPIs QEMU virt uses */
+
+typedef void (*irq_handler_t)(unsigned int irq, void *data);
+
+/* Install handler for irq and enable it at the GIC, routed to this CPU */
+int irq_register(unsigned int irq, irq_handler_t handler, void *data);
+
+void do_irq(void);
+
+#endif /* __IRQ_H__ */
@@ -22,8 +22,21 @@ int snprintf(char *s, size_t n, const char *fmt, ...) __printflike(3, 4);
 
 #ifdef STDARG_H
 int vprintf(const char *fmt, va_list args);
+int vsnprintf(char *s, size_t n, const char *fmt, va_list args);
+
+/*
+ * The formatting core of all of the above: out() gets the output in
+ * pieces, the return value is the total length.
+ */
+int vcbprintf(void (*out)(void *ctx, const char *buf, size_t len), void *ctx,
+	      const char *fmt, va_list args);
 #endif
 
+/* Same, with the arguments in an array of 64-bit words */
+int cbprintf_words(void (*out)(void *ctx, const char *buf, size_t len),
+		   void *ctx, const char *fmt, const unsigned long long *args,
+		   unsigned int nargs);
+
 int putchar(int c);
 int puts(const char *s);
 
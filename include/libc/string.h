@@ -22,6 +22,7 @@ void *memchr(const void *src, int c, size_t len);
 void *memrchr(const void *src, int c, size_t len);
 char *strchr(const char *s, int c);
 void *memset(void *dst, int val, size_t count);
+void bzero(void *dst, size_t count);
 size_t strlen(const char *s);
 size_t strnlen(const char *s, size_t maxlen);
 char *strrchr(const char *p, int ch);
@@ -0,0 +1,172 @@
+/*
+ * Logging
+ *
+ * log_printf(sys, level, fmt, ...) prints through printf() when level is
+ * enabled for the subsystem. Levels above CONFIG_LOG_LEVEL are compiled
+ * out. LOG_DEBUG and LOG_TRACE, off by default, sit behind a static key
+ * per subsystem and level: disabled, a call costs a NOP. The levels up to
+ * LOG_INFO cost one load of the subsystem's runtime level and a branch.
+ * Every subsystem starts at LOG_INFO; log_set_level() patches the keys.
+ *
+ * log_fast(fmt, ...) formats nothing: it stores a CNTVCT_EL0 timestamp,
+ * the format pointer and up to LOG_FAST_MAX_ARGS raw argument words in a
+ * record of the running CPU's ring, a few stores and no call. log_drain()
+ * formats the records to the console later, or tools/log_decode.py does
+ * it offline from a memory dump of log_rings and the ELF.
+ *
+ * The format has to be a string literal and %s arguments have to point
+ * to strings that are still around when the record is formatted, in
+ * practice string literals too. Integer arguments are stored sign
+ * extended, so the usual printf conversions and lengths work.
+ *
+ * Every CPU logs into a ring of its own, so CPUs never wait for each
+ * other to log. log_drain() merges the rings in timestamp order; a
+ * record that finds its ring full is dropped and counted. IRQ handlers
+ * may log too: IRQs are masked while a record is written.
+ */
+#ifndef __LOG_H__
+#define __LOG_H__
+
+#include <arch_help.h>
+#include <barrier.h>
+#include <cpu.h>
+#include <jump_label.h>
+#include <msr.h>
+#include <stdio.h>
+#include <types.h>
+
+/* Log levels, most severe first */
+#define LOG_ERR			0
+#define LOG_WARN		1
+#define LOG_INFO		2
+#define LOG_DEBUG		3
+#define LOG_TRACE		4
+
+/* Most verbose level compiled in, set with make CONFIG_LOG_LEVEL=n */
+#ifndef CONFIG_LOG_LEVEL
+#define CONFIG_LOG_LEVEL	LOG_TRACE
+#endif
+
+enum log_subsys {
+	LOG_CORE,
+	LOG_MMU,
+	LOG_NR_SUBSYS
+};
+
+/* Runtime level of every subsystem */
+extern u8 log_levels[LOG_NR_SUBSYS];
+
+/* Enabled with the level, LOG_DEBUG and LOG_TRACE of every subsystem */
+#define LOG_NR_KEYS		(LOG_TRACE - LOG_DEBUG + 1)
+extern struct static_key log_keys[LOG_NR_SUBSYS][LOG_NR_KEYS];
+
+/* level has to be a constant, the static key is picked at compile time */
+#define log_enabled(sys, level)						\
+	((level) <= CONFIG_LOG_LEVEL &&					\
+	 ((level) <= LOG_INFO ?						\
+	  __builtin_expect((level) <= log_levels[sys], 1) :		\
+	  static_branch_unlikely(&log_keys[sys][(level) > LOG_INFO ?	\
+						(level) - LOG_DEBUG : 0])))
+
+#define log_printf(sys, level, fmt, ...)				\
+	do {								\
+		if (log_enabled(sys, level))				\
+			printf(fmt, ##__VA_ARGS__);			\
+	} while (0)
+
+void log_set_level(enum log_subsys sys, unsigned int level);
+
+#define LOG_FAST_MAX_ARGS	5
+#define LOG_RING_RECORDS	256	/* per CPU, power of two */
+
+struct log_record {
+	u64 stamp;		/* CNTVCT_EL0 */
+	const char *fmt;
+	u32 nargs;
+	u32 cpu;
+	u64 args[LOG_FAST_MAX_ARGS];
+};
+
+/*
+ * One producer, the CPU it belongs to, and one consumer, log_drain().
+ * Thread and IRQ context of that CPU only take turns on the producer
+ * side, with IRQs masked. head and tail are free running, the
+ * producer's and the consumer's fields sit in cache lines of their own.
+ */
+struct log_ring {
+	u32 head __attribute__((aligned(64)));
+	u32 dropped;		/* records lost to a full ring */
+	u32 tail __attribute__((aligned(64)));
+	u32 dropped_seen;	/* drops log_drain() has reported */
+	struct log_record records[LOG_RING_RECORDS]
+		__attribute__((aligned(64)));
+};
+
+extern struct log_ring log_rings[NR_CPUS];
+
+static inline __attribute__((always_inline))
+void __log_fast(u64 stamp, const char *fmt, unsigned int nargs,
+		const u64 *args)
+{
+	u64 flags = local_irq_save();	/* an IRQ would take the same slot */
+	unsigned int cpu = cpu_id();
+	struct log_ring *ring = &log_rings[cpu];
+	u32 head = ring->head;
+	struct log_record *rec;
+	unsigned int i;
+
+	/* the tail store is the drainer saying it is done with the record */
+	if (head - smp_load_acquire_32(&ring->tail) == LOG_RING_RECORDS) {
+		smp_store_release_32(&ring->dropped, ring->dropped + 1);
+		local_irq_restore(flags);
+		return;
+	}
+
+	rec = &ring->records[head & (LOG_RING_RECORDS - 1)];
+	rec->stamp = stamp;
+	rec->fmt = fmt;
+	rec->nargs = nargs;
+	rec->cpu = cpu;
+	for (i = 0; i < nargs; i++)
+		rec->args[i] = args[i];
+
+	smp_store_release_32(&ring->head, head + 1);
+	local_irq_restore(flags);
+}
+
+#define LOG_ARG(x)	((u64)(unsigned long)(x))
+
+#define __LOG_ARGS0()
+#define __LOG_ARGS1(a)			LOG_ARG(a)
+#define __LOG_ARGS2(a, b)		LOG_ARG(a), LOG_ARG(b)
+#define __LOG_ARGS3(a, b, c)		LOG_ARG(a), LOG_ARG(b), LOG_ARG(c)
+#define __LOG_ARGS4(a, b, c, d)		__LOG_ARGS3(a, b, c), LOG_ARG(d)
+#define __LOG_ARGS5(a, b, c, d, e)	__LOG_ARGS4(a, b, c, d), LOG_ARG(e)
+
+/* Number of arguments, 0 to 5; more do not compile */
+#define __LOG_NARGS(_0, _1, _2, _3, _4, _5, n, ...)	n
+#define LOG_NARGS(...)	__LOG_NARGS(0, ##__VA_ARGS__, 5, 4, 3, 2, 1, 0)
+
+#define __LOG_CAT(a, b)		a##b
+#define __LOG_ARGS(n)		__LOG_CAT(__LOG_ARGS, n)
+
+#define log_fast(fmt, ...)						\
+	log_fast_at(read_msr(cntvct_el0), fmt, ##__VA_ARGS__)
+
+/* A record for something that happened at CNTVCT_EL0 value stamp */
+#define log_fast_at(stamp, fmt, ...)					\
+	__log_fast(stamp, fmt, LOG_NARGS(__VA_ARGS__),			\
+		   (const u64[LOG_FAST_MAX_ARGS]) {			\
+			   __LOG_ARGS(LOG_NARGS(__VA_ARGS__))(__VA_ARGS__) \
+		   })
+
+/* Format and print every pending record, oldest first */
+void log_drain(void);
+
+/*
+ * Pending records to log.bin on the host, and early_console_buf, which
+ * the "early: " records point into, to early.bin. -1 without semihosting.
+ */
+int log_export(void);
+
+#endif /* __LOG_H__ */
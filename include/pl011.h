@@ -1,6 +1,8 @@
 #ifndef __PL011_H__
 #define __PL011_H__
 
+#define PL011_BASE                0x09000000
+#define PL011_IRQ                 33            /* SPI 1 on QEMU virt */
 
 /* PL011 Registers */
 #define UARTDR                    0x000
@@ -20,6 +22,7 @@
 #define UARTMIS                   0x040
 #define UARTDMACR                 0x048
 
+#define PL011_UARTFR_TXFE_BIT     7       /* Transmit FIFO empty bit in UARTFR register */
 #define PL011_UARTFR_TXFF_BIT     5       /* Transmit FIFO full bit in UARTFR register */
 #define PL011_UARTFR_RXFE_BIT     4       /* Receive FIFO empty bit in UARTFR register */
 #define PL011_UARTFR_BUSY_BIT     3       /* UART busy bit in UARTFR register */
@@ -44,6 +47,20 @@
 #define PL011_UARTLCR_H_PEN       (1 << 1)      /* Parity Enable */
 #define PL011_UARTLCR_H_BRK       (1 << 0)      /* Send break */
 
+/* UARTIMSC, UARTRIS, UARTMIS and UARTICR bits */
+#define PL011_INT_RX              (1 << 4)      /* Receive FIFO at or above its level */
+#define PL011_INT_TX              (1 << 5)      /* Transmit FIFO dropped to its level */
+#define PL011_INT_RT              (1 << 6)      /* Receive timeout */
+#define PL011_INT_ERR             (0xf << 7)    /* Framing, parity, break, overrun */
+#define PL011_INT_ALL             0x7ff
+
+/* UARTIFLS, interrupt FIFO level select */
+#define PL011_UARTIFLS_TX_1_4     (1 << 0)
+#define PL011_UARTIFLS_RX_1_2     (2 << 3)
+
+/* Transmit FIFO depth: 16 up to r1p4, r1p5 has 32 */
+#define PL011_TX_FIFO_DEPTH       16
+
 #define PL011_LINE_CONTROL  (PL011_UARTLCR_H_FEN | PL011_UARTLCR_H_WLEN_8)
 
 #endif
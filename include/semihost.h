@@ -0,0 +1,40 @@
+#ifndef __SEMIHOST_H__
+#define __SEMIHOST_H__
+
+#include <stddef.h>
+
+/*
+ * Arm semihosting, HLT #0xF000 at EL2
+ *
+ * With QEMU run with -semihosting, data goes straight to the host in one
+ * trap per call instead of one emulated UART access per byte. Without
+ * it the HLT is an undefined instruction; the synchronous exception
+ * vector recognises it and returns -1, so semihost_init() can probe.
+ */
+
+#define SYS_OPEN		0x01
+#define SYS_CLOSE		0x02
+#define SYS_WRITE		0x05
+
+/* SYS_OPEN modes, as fopen() */
+#define SEMIHOST_OPEN_W		4
+#define SEMIHOST_OPEN_WB	5
+
+/* Probe once; 0 if the host answers, -1 if output has to use the UART */
+int semihost_init(void);
+int semihost_available(void);
+
+/* Host file handle, or -1 */
+int semihost_open(const char *name, int mode);
+int semihost_close(int fd);
+
+/* Write all of buf, returns 0 or -1 */
+int semihost_write(int fd, const void *buf, size_t len);
+
+/* Console output to the host's stdout, for console_set_output() */
+unsigned int semihost_console_write(const char *buf, unsigned int len);
+
+/* Write buf to a new host file name, -1 without semihosting */
+int semihost_dump(const char *name, const void *buf, size_t len);
+
+#endif /* __SEMIHOST_H__ */
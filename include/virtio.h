@@ -0,0 +1,141 @@
+#ifndef __VIRTIO_H__
+#define __VIRTIO_H__
+
+#include <types.h>
+
+/*
+ * virtio over MMIO, split virtqueues
+ *
+ * QEMU virt has 32 virtio-mmio transports at VIRTIO_MMIO_BASE, empty
+ * unless a device is plugged into them with -device xxx-device. Both the
+ * legacy interface (version 1, QEMU's default) and virtio 1.0 (version 2,
+ * -global virtio-mmio.force-legacy=false) are driven, with the same
+ * queue layout.
+ *
+ * Buffers are handed to the device by address: the image is identity
+ * mapped, so the address of anything in it is what the device sees.
+ */
+
+#define VIRTIO_MMIO_BASE		0x0a000000
+#define VIRTIO_MMIO_SLOT_SIZE		0x200
+#define VIRTIO_MMIO_NR_SLOTS		32
+
+/* Registers */
+#define VIRTIO_MMIO_MAGIC		0x000
+#define VIRTIO_MMIO_VERSION		0x004
+#define VIRTIO_MMIO_DEVICE_ID		0x008
+#define VIRTIO_MMIO_DEVICE_FEATURES	0x010
+#define VIRTIO_MMIO_DEVICE_FEATURES_SEL	0x014
+#define VIRTIO_MMIO_DRIVER_FEATURES	0x020
+#define VIRTIO_MMIO_DRIVER_FEATURES_SEL	0x024
+#define VIRTIO_MMIO_GUEST_PAGE_SIZE	0x028	/* legacy */
+#define VIRTIO_MMIO_QUEUE_SEL		0x030
+#define VIRTIO_MMIO_QUEUE_NUM_MAX	0x034
+#define VIRTIO_MMIO_QUEUE_NUM		0x038
+#define VIRTIO_MMIO_QUEUE_ALIGN		0x03c	/* legacy */
+#define VIRTIO_MMIO_QUEUE_PFN		0x040	/* legacy */
+#define VIRTIO_MMIO_QUEUE_READY		0x044
+#define VIRTIO_MMIO_QUEUE_NOTIFY	0x050
+#define VIRTIO_MMIO_INTERRUPT_STATUS	0x060
+#define VIRTIO_MMIO_INTERRUPT_ACK	0x064
+#define VIRTIO_MMIO_STATUS		0x070
+#define VIRTIO_MMIO_QUEUE_DESC_LOW	0x080
+#define VIRTIO_MMIO_QUEUE_DESC_HIGH	0x084
+#define VIRTIO_MMIO_QUEUE_AVAIL_LOW	0x090
+#define VIRTIO_MMIO_QUEUE_AVAIL_HIGH	0x094
+#define VIRTIO_MMIO_QUEUE_USED_LOW	0x0a0
+#define VIRTIO_MMIO_QUEUE_USED_HIGH	0x0a4
+
+#define VIRTIO_MMIO_MAGIC_VALUE		0x74726976	/* "virt" */
+
+#define VIRTIO_ID_CONSOLE		3
+
+/* Device status */
+#define VIRTIO_STATUS_ACKNOWLEDGE	1
+#define VIRTIO_STATUS_DRIVER		2
+#define VIRTIO_STATUS_DRIVER_OK		4
+#define VIRTIO_STATUS_FEATURES_OK	8
+#define VIRTIO_STATUS_FAILED		128
+
+#define VIRTIO_F_VERSION_1		32
+
+/* Split virtqueue, virtio 1.0 section 2.4 */
+#define VIRTQ_DESC_F_NEXT		1
+#define VIRTQ_DESC_F_WRITE		2
+#define VIRTQ_AVAIL_F_NO_INTERRUPT	1
+#define VIRTQ_USED_F_NO_NOTIFY		1
+
+#define VIRTQ_ALIGN			4096	/* of the used ring, legacy */
+
+struct virtq_desc {
+	u64 addr;
+	u32 len;
+	u16 flags;
+	u16 next;
+};
+
+struct virtq_avail {
+	u16 flags;
+	u16 idx;
+	u16 ring[];
+};
+
+struct virtq_used_elem {
+	u32 id;
+	u32 len;
+};
+
+struct virtq_used {
+	u16 flags;
+	u16 idx;
+	struct virtq_used_elem ring[];
+};
+
+/*
+ * One queue, the driver side. avail_idx and last_used are free running
+ * like the device's indices.
+ */
+struct virtq {
+	uintptr_t base;			/* of the transport */
+	unsigned int index;
+	unsigned int num;
+	struct virtq_desc *desc;
+	struct virtq_avail *avail;
+	volatile struct virtq_used *used;
+	u16 free_head;			/* descriptors chained by next */
+	u16 num_free;
+	u16 avail_idx;
+	u16 last_used;
+};
+
+/* Transport of the first device with id, 0 if there is none */
+uintptr_t virtio_mmio_find(unsigned int id);
+
+/*
+ * Reset the device and accept the features in want it offers,
+ * returns 0 or -1.
+ */
+int virtio_mmio_setup(uintptr_t base, u64 want);
+void virtio_mmio_driver_ok(uintptr_t base);
+
+/* Queue index of the device at base, in the driver's memory */
+int virtq_init(struct virtq *vq, uintptr_t base, unsigned int index);
+
+/*
+ * Add a buffer for the device to read (out) or write (!out). It is only
+ * made visible by virtq_kick(), which can publish a whole batch at
+ * once. Returns the descriptor id, or -1 when the queue is full.
+ */
+int virtq_add_buf(struct virtq *vq, const void *buf, u32 len, int out);
+void virtq_kick(struct virtq *vq);
+
+/*
+ * Next buffer the device is done with, -1 if none. *len is the length
+ * it was added with.
+ */
+int virtq_get_used(struct virtq *vq, u32 *len);
+
+/* virtio-console as the console output, 0 or -1 without the device */
+int virtio_console_init(void);
+
+#endif /* __VIRTIO_H__ */
@@ -5,6 +5,5 @@
 #include <cpu.h>
 
 #define STACK_SIZE    SZ_16K
-#define CORE_NUM      8
 
-unsigned char cpu_stack[STACK_SIZE * CORE_NUM] __attribute__((__aligned__(64)));
+unsigned char cpu_stack[STACK_SIZE * NR_CPUS] __attribute__((__aligned__(64)));
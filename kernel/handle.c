@@ -1,3 +1,5 @@
+#include <console.h>
+#include <log.h>
 #include <sizes.h>
 #include <cpu.h>
 #include <msr.h>
@@ -9,11 +11,11 @@ static void dump_esr()
 {
 	unsigned int esr = read_msr(ESR_EL2);
 	const char *err;
-	printf("ESR_ELn: 0x%016llx", esr);
-	printf("  EC:  0x%llx", ESR_EC(esr));
-	printf("  IL:  0x%llx", ESR_IL(esr));
-	printf("  ISS: 0x%llx\n", ESR_ISS(esr));
-	printf("  ELR: 0x%llx\n", read_msr(elr_el2));
+	printf("ESR_ELn: 0x%08x", esr);
+	printf("  EC:  0x%lx", ESR_EC(esr));
+	printf("  IL:  0x%lx", ESR_IL(esr));
+	printf("  ISS: 0x%lx\n", ESR_ISS(esr));
+	printf("  ELR: 0x%lx\n", read_msr(elr_el2));
 	switch (ESR_EC(esr)) {
 	case 0b000000: /* 0x00 */
 		printf("Unknown reason");
@@ -125,6 +127,8 @@ static void dump_esr()
 		printf("Unknown");
 	}
 	printf("\n");
+	log_drain();
+	console_flush();
 	asm volatile("b .");
 }
 
@@ -1,7 +1,20 @@
 #include <stdio.h>
 #include <string.h>
+#include <alternative.h>
+#include <arch_help.h>
+#include <bench.h>
+#include <cache.h>
+#include <console.h>
+#include <cpufeature.h>
+#include <early_console.h>
+#include <gic.h>
 #include <mmu.h>
 #include <io.h>
+#include <log.h>
+#include <pl011.h>
+#include <semihost.h>
+#include <sizes.h>
+#include <virtio.h>
 
 static int data = 0;
 
@@ -10,20 +23,44 @@ IMPORT_SYM(unsigned long, _image_end, image_end);
 
 void early_init(void)
 {
+	/* the host console when QEMU has -semihosting, the PL011 if not */
+	if (!semihost_init())
+		console_set_output(semihost_console_write);
 	printf("img start %lx end %lx\n", image_start, image_end);
 	printf("%lx %lx\n", early_init, printf);
+	cpu_features_init();
+	cache_init();
 	add_map("all",  image_start, image_start, image_end - image_start,
 		MT_NS | MT_NORMAL | MT_RW);
-	add_map("uart", 0x09000000, 0x09000000, 0x2000, MT_NS | MT_NORMAL |MT_RW);
+	/*
+	 * The early asm console and the exception vectors still print through
+	 * the flat PL011 address, so keep it identity mapped as device memory.
+	 */
+	add_map("uart", PL011_BASE, PL011_BASE, SZ_8K,
+		MT_NS | MT_DEVICE_nGnRE | MT_RW);
 	printf("after map\n");
 	enable_mmu();
+	early_console_replay();
+	log_fast("mmu: enabled, sctlr_el2 %lx\n", read_msr(sctlr_el2));
+	apply_alternatives();
+	gic_init();
+	console_irq_init();
+	/* a virtconsole on the QEMU command line takes over the output */
+	virtio_console_init();
+	enable_irq();
 	printf("after enable\n");
 }
 
 int main()
 {
 	early_init();
+#ifdef CONFIG_BENCH
+	libc_bench();
+#endif
 	data = data + 1023;
 	printf("end of main\n");
+	log_export();
+	log_drain();
+	console_flush();
 	return 0;
 }
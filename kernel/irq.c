@@ -0,0 +1,36 @@
+/*
+ * IRQ dispatch
+ */
+#include <gic.h>
+#include <irq.h>
+#include <log.h>
+
+static struct {
+	irq_handler_t handler;
+	void *data;
+} irq_table[NR_IRQS];
+
+int irq_register(unsigned int irq, irq_handler_t handler, void *data)
+{
+	if (irq >= NR_IRQS)
+		return -1;
+
+	irq_table[irq].handler = handler;
+	irq_table[irq].data = data;
+	gic_enable_irq(irq);
+	return 0;
+}
+
+/* Called from the IRQ vector */
+void do_irq(void)
+{
+	unsigned int irq;
+
+	while ((irq = gic_ack_irq()) != GIC_SPURIOUS_IRQ) {
+		if (irq < NR_IRQS && irq_table[irq].handler)
+			irq_table[irq].handler(irq, irq_table[irq].data);
+		else
+			log_fast("irq: unexpected irq %u\n", irq);
+		gic_eoi_irq(irq);
+	}
+}
@@ -0,0 +1,132 @@
+/*
+ * Runtime log levels, and the drain side of log_fast()
+ *
+ * The log_fast() records are formatted here, long after the log_fast()
+ * call, from the format pointer and the raw argument words.
+ * tools/log_decode.py does the same offline from a dump of log_rings.
+ */
+#include <stdio.h>
+#include <arch_help.h>
+#include <atomic.h>
+#include <console.h>
+#include <early_console.h>
+#include <log.h>
+#include <semihost.h>
+
+u8 log_levels[LOG_NR_SUBSYS] = {
+	[0 ... LOG_NR_SUBSYS - 1] = LOG_INFO,
+};
+
+struct log_ring log_rings[NR_CPUS];
+
+/* all off: no subsystem starts above LOG_INFO */
+struct static_key log_keys[LOG_NR_SUBSYS][LOG_NR_KEYS];
+
+void log_set_level(enum log_subsys sys, unsigned int level)
+{
+	unsigned int i;
+
+	log_levels[sys] = level;
+	for (i = 0; i < LOG_NR_KEYS; i++) {
+		if (LOG_DEBUG + i <= level)
+			static_key_enable(&log_keys[sys][i]);
+		else
+			static_key_disable(&log_keys[sys][i]);
+	}
+}
+
+static atomic_t log_draining;
+
+static void log_out(void *ctx, const char *buf, size_t len)
+{
+	(void)ctx;
+	console_queue(buf, len);
+}
+
+static void log_print(const struct log_record *rec, u64 freq)
+{
+	u64 sec = rec->stamp / freq;
+	u64 usec = (rec->stamp % freq) * 1000000 / freq;
+	char prefix[48];
+	int len;
+
+	len = snprintf(prefix, sizeof(prefix), "[%5llu.%06llu] %u: ",
+		       sec, usec, rec->cpu);
+	console_queue(prefix, len);
+	cbprintf_words(log_out, NULL, rec->fmt, rec->args, rec->nargs);
+}
+
+static void log_report_drops(unsigned int cpu, struct log_ring *ring)
+{
+	u32 dropped = smp_load_acquire_32(&ring->dropped);
+
+	if (dropped == ring->dropped_seen)
+		return;
+	printf("log: cpu %u dropped %u records\n", cpu,
+	       dropped - ring->dropped_seen);
+	ring->dropped_seen = dropped;
+}
+
+/*
+ * Print the records pending when the drain starts, merged over all CPUs
+ * in timestamp order. CNTVCT_EL0 is the same clock on every CPU, and
+ * each ring is in order already, so the oldest record is always at the
+ * tail of one of the rings.
+ *
+ * There is a single drainer: a CPU that finds another one draining
+ * returns right away rather than waiting for it.
+ */
+void log_drain(void)
+{
+	u32 head[NR_CPUS], tail[NR_CPUS];
+	u64 freq = read_cntfrq_el0();
+	unsigned int cpu;
+
+	if (atomic_xchg(&log_draining, 1))
+		return;
+
+	for (cpu = 0; cpu < NR_CPUS; cpu++) {
+		log_report_drops(cpu, &log_rings[cpu]);
+		tail[cpu] = log_rings[cpu].tail;
+		head[cpu] = smp_load_acquire_32(&log_rings[cpu].head);
+	}
+
+	for (;;) {
+		const struct log_record *rec, *oldest = NULL;
+		unsigned int oldest_cpu = 0;
+
+		for (cpu = 0; cpu < NR_CPUS; cpu++) {
+			if (tail[cpu] == head[cpu])
+				continue;
+			rec = &log_rings[cpu].records[tail[cpu] &
+						      (LOG_RING_RECORDS - 1)];
+			if (!oldest || rec->stamp < oldest->stamp) {
+				oldest = rec;
+				oldest_cpu = cpu;
+			}
+		}
+		if (!oldest)
+			break;
+
+		log_print(oldest, freq);
+		smp_store_release_32(&log_rings[oldest_cpu].tail,
+				     ++tail[oldest_cpu]);
+	}
+
+	console_drain();
+	atomic_xchg(&log_draining, 0);
+}
+
+/*
+ * Write the rings as they are to log.bin on the host, the dump
+ * tools/log_decode.py reads, and early_console_buf to early.bin: the
+ * replayed early messages point into it. Only with semihosting; before
+ * log_drain(), which consumes the records.
+ */
+int log_export(void)
+{
+	if (semihost_dump("log.bin", log_rings, sizeof(log_rings)))
+		return -1;
+	return semihost_dump("early.bin", early_console_buf,
+			     sizeof(early_console_buf));
+}
@@ -0,0 +1,48 @@
+/*
+ * memcpy, memmove and memset using FEAT_MOPS
+ *
+ * The CPYP/CPYM/CPYE and SETP/SETM/SETE triplets hand the whole
+ * operation to the CPU, which picks the block size, alignment and
+ * non-temporal strategy itself. The prologue/main/epilogue instructions
+ * have to be issued back to back with the same registers: an exception
+ * in the middle of an operation leaves the registers describing the
+ * remaining work and the handler resumes from the interrupted one.
+ *
+ * Each macro is a complete function body of five instructions, the
+ * replacement of an alternative at the entry of the software version on
+ * CPUs with CPU_FEAT_MOPS. apply_alternatives() runs after enable_mmu(),
+ * the CPY and SET instructions are not meant for Device memory.
+ */
+#ifndef __MOPS_H__
+#define __MOPS_H__
+
+	.arch_extension	mops
+
+/* void *memcpy(void *dst, const void *src, size_t len); */
+	.macro	memcpy_mops
+	mov	x3, x0
+	cpyfp	[x3]!, [x1]!, x2!
+	cpyfm	[x3]!, [x1]!, x2!
+	cpyfe	[x3]!, [x1]!, x2!
+	ret
+	.endm
+
+/* void *memmove(void *dst, const void *src, size_t len); */
+	.macro	memmove_mops
+	mov	x3, x0
+	cpyp	[x3]!, [x1]!, x2!
+	cpym	[x3]!, [x1]!, x2!
+	cpye	[x3]!, [x1]!, x2!
+	ret
+	.endm
+
+/* void *memset(void *dst, int val, size_t count); */
+	.macro	memset_mops
+	mov	x3, x0
+	setp	[x3]!, x2!, x1
+	setm	[x3]!, x2!, x1
+	sete	[x3]!, x2!, x1
+	ret
+	.endm
+
+#endif /* __MOPS_H__ */
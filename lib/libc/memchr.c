@@ -7,15 +7,27 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 void *memchr(const void *src, int c, size_t len)
 {
-	const unsigned char *s = src;
+	const char *end = word_range_end(src, len);
+	const word_t *w = word_align(src);
+	unsigned long cc = word_repeat(c);
+	unsigned long hit;
+	const char *s;
+
+	if (len == 0)
+		return NULL;
 
-	while (len--) {
-		if (*s == (unsigned char)c)
-			return (void *) s;
-		s++;
+	/* Only load words that start before the end of the range. */
+	hit = word_has_zero((*w ^ cc) | word_before(src));
+	while (!hit) {
+		if ((const char *)++w >= end)
+			return NULL;
+		hit = word_has_zero(*w ^ cc);
 	}
 
-	return NULL;
+	s = (const char *)w + word_first_byte(hit);
+	return s < end ? (void *)s : NULL;
 }
@@ -7,18 +7,37 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 int memcmp(const void *s1, const void *s2, size_t len)
 {
 	const unsigned char *s = s1;
 	const unsigned char *d = s2;
-	unsigned char sc;
-	unsigned char dc;
+	unsigned long a, b;
+	size_t i;
+
+	/* Short buffers: a word would read outside of them. */
+	if (len < WORD_SIZE) {
+		for (i = 0; i < len; i++) {
+			if (s[i] != d[i])
+				return s[i] - d[i];
+		}
+		return 0;
+	}
+
+	for (i = 0; i + WORD_SIZE <= len; i += WORD_SIZE) {
+		a = *(const uword_t *)(s + i);
+		b = *(const uword_t *)(d + i);
+		if (a != b)
+			return word_diff(a, b, a ^ b);
+	}
 
-	while (len--) {
-		sc = *s++;
-		dc = *d++;
-		if (sc - dc)
-			return (sc - dc);
+	/* The last word overlaps bytes already found to be equal. */
+	if (i < len) {
+		a = *(const uword_t *)(s + len - WORD_SIZE);
+		b = *(const uword_t *)(d + len - WORD_SIZE);
+		if (a != b)
+			return word_diff(a, b, a ^ b);
 	}
 
 	return 0;
@@ -6,19 +6,34 @@
 
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 #undef memrchr
 
 void *memrchr(const void *src, int c, size_t len)
 {
-	const unsigned char *s = src + (len - 1);
+	const char *end = (const char *)src + len;
+	const word_t *first = word_align(src);
+	const word_t *w;
+	unsigned long cc = word_repeat(c);
+	unsigned long match;
 
-	while (len--) {
-		if (*s == (unsigned char)c) {
-			return (void*) s;
-		}
+	if (len == 0)
+		return NULL;
 
-		s--;
-	}
+	/* Walk down from the word holding the last byte, dropping bytes past it. */
+	w = word_align(end - 1);
+	match = word_zero_bytes(*w ^ cc);
+	if ((uintptr_t)end & (WORD_SIZE - 1))
+		match &= word_before(end);
 
-	return NULL;
+	for (;;) {
+		if (w == first)
+			match &= ~word_before(src);
+		if (match)
+			return (char *)w + word_last_byte(match);
+		if (w == first)
+			return NULL;
+		match = word_zero_bytes(*--w ^ cc);
+	}
 }
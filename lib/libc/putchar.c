@@ -1,13 +1,12 @@
 #include <stdio.h>
-#include <debug.h>
+#include <console.h>
 
+/* Buffered, the console is drained at the end of every line */
 int putchar(int c)
 {
-	int res;
-	if (uart_putchar((unsigned char)c) >= 0)
-		res = c;
-	else
-		res = EOF;
+	console_putc(c);
+	if (c == '\n')
+		console_drain();
 
-	return res;
+	return (unsigned char)c;
 }
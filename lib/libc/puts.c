@@ -4,21 +4,17 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <console.h>
 #include <stdio.h>
+#include <string.h>
 
 int puts(const char *s)
 {
-	int count = 0;
+	size_t len = strlen(s);
 
-	while (*s != '\0') {
-		if (putchar(*s) == EOF)
-			return EOF;
-		s++;
-		count++;
-	}
+	console_queue(s, len);
+	console_putc('\n');
+	console_drain();
 
-	if (putchar('\n') == EOF)
-		return EOF;
-
-	return count + 1;
+	return len + 1;
 }
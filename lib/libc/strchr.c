@@ -37,17 +37,24 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 char *
 strchr(const char *p, int ch)
 {
-	char c;
+	const word_t *w = word_align(p);
+	unsigned long before = word_before(p);
+	unsigned long cc = word_repeat(ch);
+	unsigned long hit;
+	const char *s;
 
-	c = ch;
-	for (;; ++p) {
-		if (*p == c)
-			return ((char *)p);
-		if (*p == '\0')
-			return (NULL);
+	/* Stop at the first byte that is either the character or NUL. */
+	hit = word_has_zero(*w | before) | word_has_zero((*w ^ cc) | before);
+	while (!hit) {
+		w++;
+		hit = word_has_zero(*w) | word_has_zero(*w ^ cc);
 	}
-	/* NOTREACHED */
+
+	s = (const char *)w + word_first_byte(hit);
+	return (*s == (char)ch ? (char *)s : NULL);
 }
@@ -39,14 +39,48 @@
 
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 /*
  * Compare strings.
+ *
+ * s1 is walked with aligned word loads, s2 with unaligned ones; a word of
+ * s2 that would straddle a page is compared a byte at a time instead, as
+ * the string may end before the next page.
  */
 int
 strcmp(const char *s1, const char *s2)
 {
-	while (*s1 == *s2++)
-		if (*s1++ == '\0')
-			return (0);
-	return (*(const unsigned char *)s1 - *(const unsigned char *)(s2 - 1));
+	unsigned long a, b, syndrome;
+	unsigned int i;
+
+	while ((uintptr_t)s1 & (WORD_SIZE - 1)) {
+		if (*s1 != *s2 || *s1 == '\0')
+			goto bytes_differ;
+		s1++;
+		s2++;
+	}
+
+	for (;;) {
+		if (word_crosses_page(s2)) {
+			for (i = 0; i < WORD_SIZE; i++) {
+				if (*s1 != *s2 || *s1 == '\0')
+					goto bytes_differ;
+				s1++;
+				s2++;
+			}
+			continue;
+		}
+
+		a = *(const word_t *)s1;
+		b = *(const uword_t *)s2;
+		syndrome = (a ^ b) | word_has_zero(a);
+		if (syndrome)
+			return (word_diff(a, b, syndrome));
+		s1 += WORD_SIZE;
+		s2 += WORD_SIZE;
+	}
+
+bytes_differ:
+	return (*(const unsigned char *)s1 - *(const unsigned char *)s2);
 }
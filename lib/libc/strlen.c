@@ -6,12 +6,15 @@
 
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 size_t strlen(const char *s)
 {
-	const char *cursor = s;
+	const word_t *w = word_align(s);
+	unsigned long zero = word_has_zero(*w | word_before(s));
 
-	while (*cursor)
-		cursor++;
+	while (!zero)
+		zero = word_has_zero(*++w);
 
-	return cursor - s;
+	return (const char *)w + word_first_byte(zero) - s;
 }
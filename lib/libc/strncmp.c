@@ -36,18 +36,48 @@
 
 #include <string.h>
 
+#include "word_at_a_time.h"
+
+/*
+ * Same scheme as strcmp(): aligned words from s1, unaligned words from s2
+ * unless they straddle a page, bytes for the tail of n.
+ */
 int
 strncmp(const char *s1, const char *s2, size_t n)
 {
+	unsigned long a, b, syndrome;
+	unsigned int i;
+
+	while (n != 0 && ((uintptr_t)s1 & (WORD_SIZE - 1))) {
+		if (*s1 != *s2 || *s1 == '\0')
+			goto bytes_differ;
+		s1++;
+		s2++;
+		n--;
+	}
+
+	for (;;) {
+		while (n >= WORD_SIZE && !word_crosses_page(s2)) {
+			a = *(const word_t *)s1;
+			b = *(const uword_t *)s2;
+			syndrome = (a ^ b) | word_has_zero(a);
+			if (syndrome)
+				return (word_diff(a, b, syndrome));
+			s1 += WORD_SIZE;
+			s2 += WORD_SIZE;
+			n -= WORD_SIZE;
+		}
+		if (n == 0)
+			return (0);
+
+		for (i = 0; i < WORD_SIZE && n != 0; i++, n--) {
+			if (*s1 != *s2 || *s1 == '\0')
+				goto bytes_differ;
+			s1++;
+			s2++;
+		}
+	}
 
-	if (n == 0)
-		return (0);
-	do {
-		if (*s1 != *s2++)
-			return (*(const unsigned char *)s1 -
-				*(const unsigned char *)(s2 - 1));
-		if (*s1++ == '\0')
-			break;
-	} while (--n != 0);
-	return (0);
+bytes_differ:
+	return (*(const unsigned char *)s1 - *(const unsigned char *)s2);
 }
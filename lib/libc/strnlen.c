@@ -33,14 +33,27 @@
 
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 size_t
 strnlen(const char *s, size_t maxlen)
 {
+	const char *end = word_range_end(s, maxlen);
+	const word_t *w = word_align(s);
+	unsigned long zero;
 	size_t len;
 
-	for (len = 0; len < maxlen; len++, s++) {
-		if (!*s)
-			break;
+	if (maxlen == 0)
+		return (0);
+
+	/* Only load words that start before the end of the range. */
+	zero = word_has_zero(*w | word_before(s));
+	while (!zero) {
+		if ((const char *)++w >= end)
+			return (maxlen);
+		zero = word_has_zero(*w);
 	}
-	return (len);
+
+	len = (const char *)w + word_first_byte(zero) - s;
+	return (len < maxlen ? len : maxlen);
 }
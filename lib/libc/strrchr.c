@@ -32,18 +32,34 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "word_at_a_time.h"
+
 char *
 strrchr(const char *p, int ch)
 {
-	char *save;
-	char c;
+	const word_t *w = word_align(p);
+	unsigned long before = word_before(p);
+	unsigned long cc = word_repeat(ch);
+	unsigned long zero, match;
+	const char *save = NULL;
+
+	if ((char)ch == '\0')
+		return ((char *)p + strlen(p));
 
-	c = ch;
-	for (save = NULL;; ++p) {
-		if (*p == c)
-			save = (char *)p;
-		if (*p == '\0')
-			return (save);
+	for (;;) {
+		zero = word_has_zero(*w | before);
+		match = word_zero_bytes((*w ^ cc) | before);
+		if (zero) {
+			/* Only matches below the terminator count. */
+			match &= zero ^ (zero - 1);
+			if (match)
+				save = (const char *)w + word_last_byte(match);
+			return ((char *)save);
+		}
+		if (match)
+			save = (const char *)w + word_last_byte(match);
+		before = 0;
+		w++;
 	}
 	/* NOTREACHED */
 }
@@ -0,0 +1,460 @@
+/*
+ * The formatting core behind printf, vprintf, snprintf and vsnprintf
+ *
+ * vcbprintf() hands its output to a callback in pieces: every run of
+ * literal text and every converted field is one call, padding comes in
+ * chunks of up to 16 characters. The callers only differ in where the
+ * pieces go (console ring, caller's buffer).
+ *
+ * Supported, as in C99:
+ *   flags      - + space # 0
+ *   width      decimal or *
+ *   precision  . followed by decimal or *
+ *   length     hh h l ll z t j
+ *   conversion d i u o x X p c s %
+ *
+ * %p prints 0x and the address in hex, a NULL %s prints "(null)". Any
+ * other conversion character is printed as it is, with its '%'.
+ *
+ * cbprintf_words() takes the arguments from an array of 64-bit words
+ * instead, as recorded by log_fast(): ints sign extended, pointers as
+ * their address.
+ *
+ * Numbers are converted from the end: decimal two digits at a time from
+ * a table of "00".."99", with the division by 100 done as a multiply by
+ * its reciprocal, hexadecimal a nibble at a time from a digit table.
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FLAG_MINUS	0x01
+#define FLAG_PLUS	0x02
+#define FLAG_SPACE	0x04
+#define FLAG_ALT	0x08
+#define FLAG_ZERO	0x10
+#define FLAG_UPPER	0x20
+
+/* Enough for a 64-bit value in octal */
+#define NUM_BUF_SIZE	24
+
+#define PAD_CHUNK	16
+
+static const char pad_spaces[PAD_CHUNK] = "                ";
+static const char pad_zeros[PAD_CHUNK] = "0000000000000000";
+
+static const char digits_lower[16] = "0123456789abcdef";
+static const char digits_upper[16] = "0123456789ABCDEF";
+
+static const char two_digits[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+struct cb_out {
+	void (*out)(void *ctx, const char *buf, size_t len);
+	void *ctx;
+	size_t count;
+};
+
+static void emit(struct cb_out *o, const char *buf, size_t len)
+{
+	if (len) {
+		o->out(o->ctx, buf, len);
+		o->count += len;
+	}
+}
+
+static void pad(struct cb_out *o, const char *chunk, int n)
+{
+	for (; n > PAD_CHUNK; n -= PAD_CHUNK)
+		emit(o, chunk, PAD_CHUNK);
+	if (n > 0)
+		emit(o, chunk, n);
+}
+
+/*
+ * v / 100 for any 64-bit v: 0x28f5c28f5c28f5c3 is 2^66 / 25 rounded up,
+ * which is exact for v / 4 < 2^62. The same sequence a compiler emits,
+ * spelled out so the 64-bit path never falls back to a divide.
+ */
+static inline unsigned long long div100(unsigned long long v)
+{
+	return (unsigned long long)(((unsigned __int128)(v >> 2) *
+				     0x28f5c28f5c28f5c3ULL) >> 66);
+}
+
+/* v / 100 for v < 2^32: 2^37 / 100 rounded up */
+static inline unsigned int div100_32(unsigned int v)
+{
+	return (unsigned int)(((unsigned long long)v * 1374389535U) >> 37);
+}
+
+static inline char *put_two_digits(char *p, unsigned int r)
+{
+	p -= 2;
+	p[0] = two_digits[2 * r];
+	p[1] = two_digits[2 * r + 1];
+	return p;
+}
+
+/*
+ * Writes v in decimal ending at end, returns where the digits start.
+ * Once v fits 32 bits the cheaper 32-bit multiply takes over.
+ */
+static char *utoa_dec(unsigned long long v, char *end)
+{
+	char *p = end;
+	unsigned int w;
+
+	while (v >> 32) {
+		unsigned long long q = div100(v);
+
+		p = put_two_digits(p, (unsigned int)(v - q * 100));
+		v = q;
+	}
+
+	w = (unsigned int)v;
+	while (w >= 100) {
+		unsigned int q = div100_32(w);
+
+		p = put_two_digits(p, w - q * 100);
+		w = q;
+	}
+	if (w >= 10)
+		p = put_two_digits(p, w);
+	else
+		*--p = '0' + w;
+
+	return p;
+}
+
+static char *utoa_hex(unsigned long long v, char *end, const char *digits)
+{
+	char *p = end;
+
+	do {
+		*--p = digits[v & 0xf];
+		v >>= 4;
+	} while (v);
+
+	return p;
+}
+
+static char *utoa_oct(unsigned long long v, char *end)
+{
+	char *p = end;
+
+	do {
+		*--p = '0' + (v & 7);
+		v >>= 3;
+	} while (v);
+
+	return p;
+}
+
+/*
+ * One integer conversion:
+ * [spaces][sign or 0x][zeros for width][zeros for precision][digits][spaces]
+ */
+static void print_num(struct cb_out *o, unsigned long long v, bool neg,
+		      char conv, unsigned int flags, int width, int prec)
+{
+	char buf[NUM_BUF_SIZE];
+	char *end = buf + sizeof(buf);
+	char *digits;
+	char prefix[2];
+	int prefix_len = 0;
+	int ndigits, zeros, len;
+
+	if (prec == 0 && v == 0) {
+		digits = end;	/* no digits at all */
+	} else if (conv == 'x' || conv == 'X' || conv == 'p') {
+		digits = utoa_hex(v, end, (flags & FLAG_UPPER) ?
+				  digits_upper : digits_lower);
+	} else if (conv == 'o') {
+		digits = utoa_oct(v, end);
+	} else {
+		digits = utoa_dec(v, end);
+	}
+	ndigits = end - digits;
+
+	if (neg)
+		prefix[prefix_len++] = '-';
+	else if (conv == 'd' || conv == 'i') {
+		if (flags & FLAG_PLUS)
+			prefix[prefix_len++] = '+';
+		else if (flags & FLAG_SPACE)
+			prefix[prefix_len++] = ' ';
+	}
+
+	if (conv == 'p' ||
+	    ((flags & FLAG_ALT) && (conv == 'x' || conv == 'X') && v)) {
+		prefix[prefix_len++] = '0';
+		prefix[prefix_len++] = (flags & FLAG_UPPER) ? 'X' : 'x';
+	}
+
+	zeros = prec > ndigits ? prec - ndigits : 0;
+	/* the alternate octal form starts with a 0, one from precision will do */
+	if ((flags & FLAG_ALT) && conv == 'o' && !zeros &&
+	    (ndigits == 0 || *digits != '0'))
+		zeros = 1;
+
+	len = prefix_len + zeros + ndigits;
+	if (width > len && (flags & FLAG_ZERO) && prec < 0 &&
+	    !(flags & FLAG_MINUS)) {
+		zeros += width - len;
+		len = width;
+	}
+
+	if (!(flags & FLAG_MINUS))
+		pad(o, pad_spaces, width - len);
+	emit(o, prefix, prefix_len);
+	pad(o, pad_zeros, zeros);
+	emit(o, digits, ndigits);
+	if (flags & FLAG_MINUS)
+		pad(o, pad_spaces, width - len);
+}
+
+static void print_str(struct cb_out *o, const char *s, size_t len,
+		      unsigned int flags, int width)
+{
+	int n = (int)len;
+
+	if (!(flags & FLAG_MINUS))
+		pad(o, pad_spaces, width - n);
+	emit(o, s, len);
+	if (flags & FLAG_MINUS)
+		pad(o, pad_spaces, width - n);
+}
+
+enum length {
+	LEN_HH,
+	LEN_H,
+	LEN_INT,
+	LEN_L,
+	LEN_LL,
+	LEN_PTR,
+};
+
+/* Where the arguments come from: a va_list, or an array of 64-bit words */
+struct fmt_args {
+	va_list ap;
+	const unsigned long long *words;
+	unsigned int nwords;
+};
+
+/*
+ * The next argument as 64 bits, int and long sign extended. Words are
+ * taken as they are, the caller truncates them to the conversion's type.
+ * Missing words read as 0.
+ */
+static unsigned long long next_arg(struct fmt_args *a, enum length length)
+{
+	if (a->words) {
+		if (!a->nwords)
+			return 0;
+		a->nwords--;
+		return *a->words++;
+	}
+
+	switch (length) {
+	case LEN_PTR:
+		return (unsigned long)va_arg(a->ap, void *);
+	case LEN_LL:
+		return va_arg(a->ap, long long);
+	case LEN_L:
+		return va_arg(a->ap, long);
+	default:
+		return va_arg(a->ap, int);
+	}
+}
+
+static int format(struct cb_out *o, const char *fmt, struct fmt_args *a)
+{
+	while (*fmt) {
+		const char *start = fmt;
+		unsigned int flags = 0;
+		int width = 0, prec = -1;
+		enum length length = LEN_INT;
+		unsigned long long v;
+		bool neg = false;
+		const char *s;
+		char c;
+
+		/* literal text up to the next conversion in one piece */
+		while (*fmt && *fmt != '%')
+			fmt++;
+		emit(o, start, fmt - start);
+		if (!*fmt)
+			break;
+		start = fmt++;
+
+		for (;; fmt++) {
+			if (*fmt == '-')
+				flags |= FLAG_MINUS;
+			else if (*fmt == '+')
+				flags |= FLAG_PLUS;
+			else if (*fmt == ' ')
+				flags |= FLAG_SPACE;
+			else if (*fmt == '#')
+				flags |= FLAG_ALT;
+			else if (*fmt == '0')
+				flags |= FLAG_ZERO;
+			else
+				break;
+		}
+
+		if (*fmt == '*') {
+			width = (int)next_arg(a, LEN_INT);
+			if (width < 0) {
+				flags |= FLAG_MINUS;
+				width = -width;
+			}
+			fmt++;
+		} else {
+			while (*fmt >= '0' && *fmt <= '9')
+				width = width * 10 + (*fmt++ - '0');
+		}
+
+		if (*fmt == '.') {
+			fmt++;
+			prec = 0;
+			if (*fmt == '*') {
+				prec = (int)next_arg(a, LEN_INT);
+				if (prec < 0)
+					prec = -1;
+				fmt++;
+			} else {
+				while (*fmt >= '0' && *fmt <= '9')
+					prec = prec * 10 + (*fmt++ - '0');
+			}
+		}
+
+		switch (*fmt) {
+		case 'h':
+			length = LEN_H;
+			if (*++fmt == 'h') {
+				length = LEN_HH;
+				fmt++;
+			}
+			break;
+		case 'l':
+			length = LEN_L;
+			if (*++fmt == 'l') {
+				length = LEN_LL;
+				fmt++;
+			}
+			break;
+		case 'z':
+		case 't':
+		case 'j':
+			/* size_t, ptrdiff_t and intmax_t are all 64-bit */
+			length = LEN_LL;
+			fmt++;
+			break;
+		}
+
+		switch (c = *fmt) {
+		case 'd':
+		case 'i': {
+			long long sv = next_arg(a, length);
+
+			if (length == LEN_L)
+				sv = (long)sv;
+			else if (length < LEN_L)
+				sv = (int)sv;
+			if (length == LEN_H)
+				sv = (short)sv;
+			else if (length == LEN_HH)
+				sv = (signed char)sv;
+
+			neg = sv < 0;
+			v = neg ? -(unsigned long long)sv : (unsigned long long)sv;
+			print_num(o, v, neg, c, flags, width, prec);
+			break;
+		}
+		case 'X':
+			flags |= FLAG_UPPER;
+			/* fall through */
+		case 'u':
+		case 'o':
+		case 'x':
+			v = next_arg(a, length);
+			if (length == LEN_L)
+				v = (unsigned long)v;
+			else if (length < LEN_L)
+				v = (unsigned int)v;
+			if (length == LEN_H)
+				v = (unsigned short)v;
+			else if (length == LEN_HH)
+				v = (unsigned char)v;
+
+			print_num(o, v, false, c, flags, width, prec);
+			break;
+		case 'p':
+			v = next_arg(a, LEN_PTR);
+			print_num(o, v, false, c, flags, width, prec);
+			break;
+		case 'c': {
+			char ch = (char)next_arg(a, LEN_INT);
+
+			print_str(o, &ch, 1, flags, width);
+			break;
+		}
+		case 's':
+			s = (const char *)(unsigned long)next_arg(a, LEN_PTR);
+			if (!s)
+				s = "(null)";
+			print_str(o, s, prec < 0 ? strlen(s) : strnlen(s, prec),
+				  flags, width);
+			break;
+		case '%':
+			emit(o, fmt, 1);
+			break;
+		default:
+			/* unknown: print it as it stands */
+			if (!c)
+				fmt--;
+			emit(o, start, fmt + 1 - start);
+			break;
+		}
+		fmt++;
+	}
+
+	return (int)o->count;
+}
+
+int vcbprintf(void (*out)(void *ctx, const char *buf, size_t len), void *ctx,
+	      const char *fmt, va_list args)
+{
+	struct cb_out o = { out, ctx, 0 };
+	struct fmt_args a = { .words = NULL };
+	int count;
+
+	va_copy(a.ap, args);
+	count = format(&o, fmt, &a);
+	va_end(a.ap);
+
+	return count;
+}
+
+int cbprintf_words(void (*out)(void *ctx, const char *buf, size_t len),
+		   void *ctx, const char *fmt, const unsigned long long *args,
+		   unsigned int nargs)
+{
+	struct cb_out o = { out, ctx, 0 };
+	struct fmt_args a = { .words = args, .nwords = nargs };
+
+	return format(&o, fmt, &a);
+}
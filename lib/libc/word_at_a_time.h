@@ -0,0 +1,103 @@
+/*
+ * Helpers for scanning memory a word at a time.
+ *
+ * Scans load whole aligned words, so they never touch a page that holds
+ * none of the bytes they were asked to look at, even though they may read
+ * a few bytes on either side of the buffer. Unaligned loads (uword_t) are
+ * only used where the caller has checked word_crosses_page(). Bytes are
+ * numbered from the least significant end, which assumes a little-endian
+ * CPU.
+ */
+
+#ifndef WORD_AT_A_TIME_H
+#define WORD_AT_A_TIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "word_at_a_time.h assumes a little-endian CPU"
+#endif
+
+typedef unsigned long __attribute__((__may_alias__)) word_t;
+typedef unsigned long __attribute__((__may_alias__, __aligned__(1))) uword_t;
+
+#define WORD_SIZE	sizeof(word_t)
+/* Smallest translation granule, loads never cross a boundary of this */
+#define WORD_PAGE_SIZE	4096UL
+#define WORD_ONES	0x0101010101010101UL
+#define WORD_HIGHS	0x8080808080808080UL
+#define WORD_LOWS	0x7f7f7f7f7f7f7f7fUL
+
+static inline const word_t *word_align(const void *p)
+{
+	return (const word_t *)((uintptr_t)p & ~(WORD_SIZE - 1));
+}
+
+/* "c" in every byte of a word */
+static inline unsigned long word_repeat(unsigned char c)
+{
+	return WORD_ONES * c;
+}
+
+/*
+ * High bit set in the byte of the first (least significant) zero byte of
+ * "w". Bytes above it may be flagged too, so only the first hit is exact.
+ */
+static inline unsigned long word_has_zero(unsigned long w)
+{
+	return (w - WORD_ONES) & ~w & WORD_HIGHS;
+}
+
+/* High bit set in exactly the bytes of "w" that are zero */
+static inline unsigned long word_zero_bytes(unsigned long w)
+{
+	return ~(((w & WORD_LOWS) + WORD_LOWS) | w | WORD_LOWS);
+}
+
+/* Bytes of the word holding "p" that come before "p", all bits set */
+static inline unsigned long word_before(const void *p)
+{
+	return (1UL << (8 * ((uintptr_t)p & (WORD_SIZE - 1)))) - 1;
+}
+
+/* Index of the lowest flagged byte, RBIT + CLZ on AArch64 */
+static inline unsigned int word_first_byte(unsigned long mask)
+{
+	return __builtin_ctzl(mask) >> 3;
+}
+
+/* Index of the highest flagged byte, CLZ on AArch64 */
+static inline unsigned int word_last_byte(unsigned long mask)
+{
+	return (63 - __builtin_clzl(mask)) >> 3;
+}
+
+/* Whether an unaligned word load from "p" would touch two pages */
+static inline int word_crosses_page(const void *p)
+{
+	return ((uintptr_t)p & (WORD_PAGE_SIZE - 1)) > WORD_PAGE_SIZE - WORD_SIZE;
+}
+
+/*
+ * Compare the first byte flagged in "syndrome" of the words "a" and "b",
+ * the way memcmp() orders them. REV puts the lowest addressed byte on
+ * top, so CLZ finds the first flagged byte in memory order.
+ */
+static inline int word_diff(unsigned long a, unsigned long b,
+			    unsigned long syndrome)
+{
+	unsigned int shift = __builtin_clzl(__builtin_bswap64(syndrome)) & ~7U;
+
+	return (int)((a >> shift) & 0xff) - (int)((b >> shift) & 0xff);
+}
+
+/* End of the [p, p + len) range, clamped when it would wrap around */
+static inline const char *word_range_end(const void *p, size_t len)
+{
+	if (len > UINTPTR_MAX - (uintptr_t)p)
+		return (const char *)UINTPTR_MAX;
+	return (const char *)p + len;
+}
+
+#endif /* WORD_AT_A_TIME_H */
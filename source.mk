@@ -7,23 +7,25 @@ INCLUDE_DIR += include \
 	       plat/include
 
 KERNEL_SRCS += arch/arm64/entry.S \
+	       arch/arm64/alternative.c \
 	       arch/arm64/spinlock.S \
+	       arch/arm64/cache_helpers.S \
+	       arch/arm64/cache.c \
+	       arch/arm64/cpufeature.c \
 	       arch/arm64/exception.S \
+	       arch/arm64/jump_label.c \
 	       arch/arm64/mmu.c \
 	       kernel/cpu.c \
 	       kernel/handle.c \
-	       kernel/init.c
+	       kernel/init.c \
+	       kernel/irq.c \
+	       kernel/log.c
 
 
 PLATFORM_SRCS +=
 
 LIBC_SRCS +=  \
-	     lib/libc/memchr.c \
-	     lib/libc/memcmp.c \
-	     lib/libc/memcpy.c \
-	     lib/libc/memmove.c \
 	     lib/libc/memrchr.c \
-	     lib/libc/memset.c \
 	     lib/libc/printf.c \
 	     lib/libc/putchar.c \
 	     lib/libc/puts.c \
@@ -31,12 +33,39 @@ LIBC_SRCS +=  \
 	     lib/libc/strchr.c \
 	     lib/libc/strcmp.c \
 	     lib/libc/strlcpy.c \
-	     lib/libc/strlen.c \
 	     lib/libc/strncmp.c \
 	     lib/libc/strnlen.c \
-	     lib/libc/strrchr.c
+	     lib/libc/strrchr.c \
+	     lib/libc/vcbprintf.c
+
+# FP/SIMD state handling and the NEON string routines, built without
+# -mgeneral-regs-only (make CONFIG_SIMD=y)
+ifeq ($(CONFIG_SIMD),y)
+SIMD_SRCS += arch/arm64/fpsimd.S \
+	     lib/libc/aarch64/memchr_neon.S \
+	     lib/libc/aarch64/memcmp_neon.S \
+	     lib/libc/aarch64/memcpy_neon.S \
+	     lib/libc/aarch64/memset_neon.S \
+	     lib/libc/aarch64/strlen_neon.S
+else
+LIBC_SRCS += \
+	     lib/libc/memchr.c \
+	     lib/libc/memcmp.c \
+	     lib/libc/aarch64/memcpy.S \
+	     lib/libc/aarch64/memset.S \
+	     lib/libc/strlen.c
+endif
 
-DRIVER_SRCS += driver/uart/pl011.S \
-	       driver/uart/uart.c
+DRIVER_SRCS += driver/console/console.c \
+	       driver/console/early_console.c \
+	       driver/gic/gicv3.c \
+	       driver/semihost/semihost.c \
+	       driver/uart/pl011.S \
+	       driver/uart/uart.c \
+	       driver/virtio/virtio_console.c \
+	       driver/virtio/virtio_mmio.c
 
-TEST_SRCS +=
+# libc micro-benchmark image (make bench)
+ifeq ($(CONFIG_BENCH),y)
+TEST_SRCS += test/libc_bench.c
+endif
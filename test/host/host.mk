@@ -0,0 +1,61 @@
+# Native build of lib/libc and arch/arm64/mmu.c, run from the top level
+# with "make host". The libc routines are built against the kernel headers
+# and get their symbols renamed to k_* so they can sit next to glibc in
+# one binary. mmu.c is built as it is, test/host/include stands in for
+# the system register accessors and the static keys.
+#
+# Only the C versions of the string routines run here; the aarch64 .S
+# ones need EL2 (memset reads SCTLR_EL2) and are covered by "make bench".
+#
+# tools/log_decode.py is checked against the kernel's cbprintf_words(): the
+# binary writes a log_rings dump and the text log_drain() would print for
+# it, the decoder has to print the same from the dump and the binary.
+
+HOSTCC ?= cc
+HOSTOBJCOPY ?= objcopy
+BUILD ?= build/host
+
+HOST_CFLAGS = -O2 -g -Wall
+
+HOST_LIBC_CFLAGS = $(HOST_CFLAGS) -ffreestanding -fno-builtin -nostdinc \
+		   -Iinclude/libc -Iinclude/libc/aarch64 -Iinclude
+HOST_MMU_CFLAGS = $(HOST_CFLAGS) -Itest/host/include -Iarch/arm64/include \
+		  -Iinclude
+
+HOST_LIBC_SRCS = memchr memcmp memcpy memmove memrchr memset snprintf strchr \
+		 strcmp strlcpy strlen strncmp strnlen strrchr vcbprintf
+HOST_LIBC_OBJS = $(addprefix $(BUILD)/libc/, $(addsuffix .o, $(HOST_LIBC_SRCS)))
+
+HOST_TEST_SRCS = test/host/main.c test/host/libc_test.c test/host/mmu_test.c \
+		 test/host/log_decode_test.c
+HOST_OBJS = $(HOST_LIBC_OBJS) $(BUILD)/mmu.o \
+	    $(addprefix $(BUILD)/, $(notdir $(HOST_TEST_SRCS:.c=.o)))
+
+HOST_TEST = $(BUILD)/host_test
+
+.PHONY: all
+
+all: $(HOST_TEST)
+	$(HOST_TEST)
+	$(HOST_TEST) logdump $(BUILD)/log.bin $(BUILD)/log.expected
+	tools/log_decode.py --freq 1000000 $(HOST_TEST) $(BUILD)/log.bin | \
+		diff -u $(BUILD)/log.expected -
+	@echo "log_decode.py            ok"
+
+# without PIE, the pointers in the log records are addresses in the file
+$(HOST_TEST): $(HOST_OBJS)
+	$(HOSTCC) -no-pie $(HOST_OBJS) -o $@
+
+$(BUILD)/libc/%.o: lib/libc/%.c
+	@mkdir -p $(dir $@)
+	$(HOSTCC) $(HOST_LIBC_CFLAGS) -c $< -o $@.tmp
+	$(HOSTOBJCOPY) --prefix-symbols=k_ $@.tmp $@
+	@rm -f $@.tmp
+
+$(BUILD)/mmu.o: arch/arm64/mmu.c
+	@mkdir -p $(dir $@)
+	$(HOSTCC) $(HOST_MMU_CFLAGS) -c $< -o $@
+
+$(BUILD)/%.o: test/host/%.c test/host/host_test.h
+	@mkdir -p $(dir $@)
+	$(HOSTCC) $(HOST_MMU_CFLAGS) -c $< -o $@
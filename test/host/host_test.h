@@ -0,0 +1,35 @@
+/*
+ * Host test harness for lib/libc and the page-table code (make host)
+ */
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+#include <stdio.h>
+
+/* Failed checks so far, only the first few are printed */
+extern unsigned long host_failures;
+#define HOST_MAX_REPORTS	20
+
+#define CHECK(cond, fmt, ...)						\
+	do {								\
+		if (!(cond) && host_failures++ < HOST_MAX_REPORTS)	\
+			printf("FAIL %s:%d: " fmt "\n", __FILE__,	\
+			       __LINE__, ##__VA_ARGS__);		\
+	} while (0)
+
+#define RUN_TEST(fn)							\
+	do {								\
+		unsigned long failed = host_failures;			\
+		fn();							\
+		printf("%-24s %s\n", #fn,				\
+		       host_failures == failed ? "ok" : "FAILED");	\
+	} while (0)
+
+void libc_test(void);
+void mmu_test(void);
+void mmu_bench(void);
+
+/* Records and their expected text for tools/log_decode.py */
+int log_dump(const char *dump, const char *expected);
+
+#endif /* __HOST_TEST_H__ */
@@ -0,0 +1,89 @@
+/*
+ * arch_help.h for the host build
+ *
+ * System register writes land in host_sysregs where the tests can look at
+ * them, barriers, cache maintenance and IRQ masking do nothing and the
+ * counter is CLOCK_MONOTONIC in nanoseconds.
+ */
+#ifndef __ARCH_HELPERS_H__
+#define __ARCH_HELPERS_H__
+
+#include <arch.h>
+#include <stdint.h>
+#include <time.h>
+
+struct host_sysregs {
+	uint64_t mair_el2;
+	uint64_t tcr_el2;
+	uint64_t ttbr0_el2;
+	uint64_t sctlr_el2;
+};
+
+extern struct host_sysregs host_sysregs;
+
+#define HOST_DEFINE_SYSREG_RW_FUNCS(_name)				\
+	static inline uint64_t read_##_name(void)			\
+	{								\
+		return host_sysregs._name;				\
+	}								\
+	static inline void write_##_name(uint64_t v)			\
+	{								\
+		host_sysregs._name = v;					\
+	}
+
+HOST_DEFINE_SYSREG_RW_FUNCS(mair_el2)
+HOST_DEFINE_SYSREG_RW_FUNCS(tcr_el2)
+HOST_DEFINE_SYSREG_RW_FUNCS(ttbr0_el2)
+HOST_DEFINE_SYSREG_RW_FUNCS(sctlr_el2)
+
+static inline void isb(void)
+{
+	__asm__ volatile("" ::: "memory");
+}
+
+static inline void dsbish(void)
+{
+	__asm__ volatile("" ::: "memory");
+}
+
+static inline void dsbishst(void)
+{
+	__asm__ volatile("" ::: "memory");
+}
+
+/* no interrupts here */
+static inline uint64_t local_irq_save(void)
+{
+	return 0;
+}
+
+static inline void local_irq_restore(uint64_t flags)
+{
+	(void)flags;
+}
+
+static inline void dcsw_op_all(uint32_t op)
+{
+	(void)op;
+}
+
+/* a single CPU, 0 */
+static inline uint64_t read_mpidr_el1(void)
+{
+	return 0;
+}
+
+static inline uint64_t read_cntfrq_el0(void)
+{
+	return 1000000000ULL;
+}
+
+static inline uint64_t read_cntpct_el0(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#endif /* __ARCH_HELPERS_H__ */
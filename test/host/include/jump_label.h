@@ -0,0 +1,33 @@
+/*
+ * static keys for the host build: plain flags, nothing is patched
+ */
+#ifndef __JUMP_LABEL_H__
+#define __JUMP_LABEL_H__
+
+#include <stdbool.h>
+
+struct static_key {
+	int enabled;
+};
+
+#define DEFINE_STATIC_KEY_FALSE(name)	struct static_key name = { 0 }
+#define DECLARE_STATIC_KEY_FALSE(name)	extern struct static_key name
+
+#define static_branch_unlikely(key)	__builtin_expect((key)->enabled, 0)
+
+static inline bool static_key_enabled(const struct static_key *key)
+{
+	return key->enabled;
+}
+
+static inline void static_key_enable(struct static_key *key)
+{
+	key->enabled = 1;
+}
+
+static inline void static_key_disable(struct static_key *key)
+{
+	key->enabled = 0;
+}
+
+#endif /* __JUMP_LABEL_H__ */
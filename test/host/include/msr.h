@@ -0,0 +1,10 @@
+/*
+ * msr.h for the host build: read_msr(name) is read_name() from the host
+ * arch_help.h.
+ */
+#ifndef __MSR__
+#define __MSR__
+
+#define read_msr(name)		read_##name()
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * types for the host build: the fixed width types come from the C library,
+ * the kernel short names keep their target definitions so format strings
+ * check the same on both
+ */
+
+#ifndef __TYPES_H__
+#define __TYPES_H__
+
+#include <stdint.h>
+
+typedef	int8_t s8;
+typedef	int16_t s16;
+typedef	int32_t s32;
+
+typedef	uint8_t u8;
+typedef	uint16_t u16;
+typedef	uint32_t u32;
+
+typedef	unsigned long long u64;
+typedef	long long s64;
+
+#endif
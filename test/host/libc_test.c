@@ -0,0 +1,453 @@
+/*
+ * lib/libc against glibc
+ *
+ * The kernel routines are linked in with every symbol renamed to k_<name>
+ * and run on random strings and buffers next to their glibc counterparts.
+ * The buffers sit right after and right before a PROT_NONE page, so a
+ * routine reading or writing past either end of its argument faults.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "host_test.h"
+
+size_t k_strlen(const char *s);
+size_t k_strnlen(const char *s, size_t maxlen);
+char *k_strchr(const char *s, int c);
+char *k_strrchr(const char *s, int c);
+void *k_memchr(const void *src, int c, size_t len);
+void *k_memrchr(const void *src, int c, size_t len);
+int k_memcmp(const void *s1, const void *s2, size_t len);
+int k_strcmp(const char *s1, const char *s2);
+int k_strncmp(const char *s1, const char *s2, size_t n);
+void *k_memcpy(void *dst, const void *src, size_t len);
+void *k_memmove(void *dst, const void *src, size_t len);
+void *k_memset(void *dst, int val, size_t count);
+size_t k_strlcpy(char *dst, const char *src, size_t dsize);
+int k_snprintf(char *s, size_t n, const char *fmt, ...);
+int k_cbprintf_words(void (*out)(void *ctx, const char *buf, size_t len),
+		     void *ctx, const char *fmt, const unsigned long long *args,
+		     unsigned int nargs);
+
+#define PAGE		4096
+#define AREA_PAGES	32
+#define ITERATIONS	200000
+/* Copies and fills mostly stay short, one in BIG_ONE_IN goes up to 64K */
+#define SHORT_MAX	600
+#define BIG_ONE_IN	64
+
+/* Usable pages between the two guard pages */
+static char *lo, *hi;
+/* Same size as [lo, hi), where the expected results are built */
+static char *ref;
+
+static int sgn(int x)
+{
+	return (x > 0) - (x < 0);
+}
+
+static size_t rand_len(void)
+{
+	if (rand() % BIG_ONE_IN == 0)
+		return rand() % (64 * 1024);
+	return rand() % SHORT_MAX;
+}
+
+/* Either at the start of the area, misaligned, or ending on its last byte */
+static char *place(size_t len)
+{
+	if (rand() & 1)
+		return hi - len;
+	return lo + rand() % 64;
+}
+
+static void fill_random(char *p, size_t len)
+{
+	while (len--)
+		*p++ = rand();
+}
+
+static void test_scan(void)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		int len = rand() % 80;
+		char *s = place(len + 1);
+		char *ss;
+		size_t ml, sub, mx;
+		int c;
+
+		for (int j = 0; j < len; j++)
+			s[j] = 1 + rand() % 6 + (rand() % 8 == 0 ? 0x7a : 0);
+		s[len] = 0;
+		c = (rand() % 4 == 0) ? 0 : 1 + rand() % 7;
+		if (rand() % 10 == 0)
+			c += 0x100;	/* only the low byte counts */
+
+		CHECK(k_strlen(s) == strlen(s), "strlen len %d", len);
+		mx = rand() % 100;
+		CHECK(k_strnlen(s, mx) == strnlen(s, mx), "strnlen %zu", mx);
+		CHECK(k_strnlen(s, (size_t)-1) == strlen(s), "strnlen max");
+		CHECK(k_strchr(s, c) == strchr(s, c), "strchr %#x", c);
+		CHECK(k_strrchr(s, c) == strrchr(s, c), "strrchr %#x", c);
+
+		ml = len + 1;
+		sub = rand() % (ml + 1);
+		ss = s + (ml - sub);
+		CHECK(k_memchr(s, c, ml) == memchr(s, c, ml), "memchr %zu", ml);
+		CHECK(k_memrchr(s, c, ml) == memrchr(s, c, ml), "memrchr %zu", ml);
+		CHECK(k_memchr(ss, c, sub) == memchr(ss, c, sub), "memchr %zu", sub);
+		CHECK(k_memrchr(ss, c, sub) == memrchr(ss, c, sub),
+		      "memrchr %zu", sub);
+	}
+}
+
+static void test_compare(void)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		int len = rand() % 80;
+		char *s = lo + rand() % 16;
+		char *s2 = hi - len - 2 - rand() % 2;
+		size_t n;
+
+		for (int j = 0; j < len; j++)
+			s[j] = 1 + rand() % 255;
+		s[len] = 0;
+		memcpy(s2, s, len + 1);
+		s2[len + 1] = 0;
+		/* a different byte, maybe the terminator, or none */
+		if (len && rand() % 3)
+			s2[rand() % (len + 1)] = rand();
+
+		n = rand() % (strnlen(s2, len) + 1);
+		CHECK(sgn(k_memcmp(s, s2, n)) == sgn(memcmp(s, s2, n)),
+		      "memcmp %zu", n);
+		CHECK(sgn(k_strcmp(s, s2)) == sgn(strcmp(s, s2)), "strcmp");
+		CHECK(sgn(k_strcmp(s2, s)) == sgn(strcmp(s2, s)), "strcmp");
+		n = rand() % 100;
+		CHECK(sgn(k_strncmp(s, s2, n)) == sgn(strncmp(s, s2, n)),
+		      "strncmp %zu", n);
+		CHECK(sgn(k_strncmp(s2, s, n)) == sgn(strncmp(s2, s, n)),
+		      "strncmp %zu", n);
+	}
+}
+
+/*
+ * memcpy between two places in the area, memmove also within one region
+ * in either direction. The whole area is compared afterwards, so stray
+ * stores anywhere show up as well.
+ */
+static void test_copy(void)
+{
+	size_t area = hi - lo;
+
+	fill_random(lo, area);
+	for (int i = 0; i < ITERATIONS / 4; i++) {
+		size_t len = rand_len();
+		char *src = place(len);
+		char *dst;
+		void *ret;
+		int move = rand() & 1;
+
+		if (move) {
+			/* overlapping most of the time */
+			long delta = rand() % (2 * 128 + 1) - 128;
+
+			if (rand() % 4 == 0)
+				delta = rand() % (2 * len + 1) - (long)len;
+			dst = src + delta;
+			if (dst < lo)
+				dst = lo;
+			if (dst + len > hi)
+				dst = hi - len;
+		} else {
+			dst = (src < lo + area / 2) ? hi - len - rand() % 64 :
+						       lo + rand() % 64;
+			if (dst < src ? dst + len > src : src + len > dst)
+				continue;
+		}
+
+		memcpy(ref, lo, area);
+		memmove(ref + (dst - lo), ref + (src - lo), len);
+		ret = move ? k_memmove(dst, src, len) : k_memcpy(dst, src, len);
+
+		CHECK(ret == dst, "%s return", move ? "memmove" : "memcpy");
+		CHECK(!memcmp(ref, lo, area), "%s len %zu src +%ld dst +%ld",
+		      move ? "memmove" : "memcpy", len, (long)(src - lo),
+		      (long)(dst - lo));
+		if (memcmp(ref, lo, area))
+			memcpy(lo, ref, area);
+	}
+}
+
+static void test_set(void)
+{
+	size_t area = hi - lo;
+
+	fill_random(lo, area);
+	memcpy(ref, lo, area);
+	for (int i = 0; i < ITERATIONS / 4; i++) {
+		size_t len = rand_len();
+		char *dst = place(len);
+		int val = (rand() % 4 == 0) ? 0 : rand();
+		void *ret;
+
+		memset(ref + (dst - lo), val, len);
+		ret = k_memset(dst, val, len);
+
+		CHECK(ret == dst, "memset return");
+		CHECK(!memcmp(ref, lo, area), "memset len %zu dst +%ld val %#x",
+		      len, (long)(dst - lo), val);
+		if (memcmp(ref, lo, area))
+			memcpy(lo, ref, area);
+	}
+}
+
+/* glibc only has strlcpy since 2.38, so the reference is spelled out */
+static size_t ref_strlcpy(char *dst, const char *src, size_t dsize)
+{
+	size_t len = strlen(src);
+
+	if (dsize) {
+		size_t n = len < dsize - 1 ? len : dsize - 1;
+
+		memcpy(dst, src, n);
+		dst[n] = 0;
+	}
+	return len;
+}
+
+static void test_strlcpy(void)
+{
+	char *src = lo;
+
+	for (int i = 0; i < ITERATIONS / 4; i++) {
+		size_t len = rand() % 300;
+		size_t dsize = rand() % 320;
+		char *dst = hi - dsize;
+		char *exp = ref + (dst - lo);
+
+		for (size_t j = 0; j < len; j++)
+			src[j] = 1 + rand() % 255;
+		src[len] = 0;
+		fill_random(dst, dsize);
+		memcpy(exp, dst, dsize);
+
+		CHECK(k_strlcpy(dst, src, dsize) ==
+		      ref_strlcpy(exp, src, dsize), "strlcpy return");
+		CHECK(!memcmp(dst, exp, dsize), "strlcpy len %zu size %zu",
+		      len, dsize);
+	}
+}
+
+#define NO_STAR		1000
+
+/*
+ * Builds "<text>%[flags][width][.prec][length]<conv><text>", star_width and
+ * star_prec are the arguments for a '*' or NO_STAR
+ */
+static void random_format(char *fmt, const char *length, char conv,
+			  int *star_width, int *star_prec)
+{
+	static const char flags[] = "-+ #0";
+	char *p = fmt;
+
+	*star_width = *star_prec = NO_STAR;
+	if (rand() & 1)
+		*p++ = 'a' + rand() % 26;
+	*p++ = '%';
+	for (int i = 0; i < 5; i++)
+		if (rand() % 4 == 0)
+			*p++ = flags[i];
+	switch (rand() % 4) {
+	case 0:
+		p += sprintf(p, "%d", rand() % 30);
+		break;
+	case 1:
+		*p++ = '*';
+		*star_width = rand() % 50 - 25;
+		break;
+	}
+	switch (rand() % 4) {
+	case 0:
+		p += sprintf(p, ".%d", rand() % 25);
+		break;
+	case 1:
+		*p++ = '.';
+		break;
+	case 2:
+		*p++ = '.';
+		*p++ = '*';
+		*star_prec = rand() % 30 - 5;
+		break;
+	}
+	p = stpcpy(p, length);
+	*p++ = conv;
+	if (rand() & 1)
+		*p++ = ':';
+	*p = 0;
+}
+
+static unsigned long long interesting_number(void)
+{
+	static const unsigned long long edges[] = {
+		0, 1, 9, 10, 99, 100, 101, 999, 4294967295ULL, 4294967296ULL,
+		9999999999ULL, 10000000000ULL, 9223372036854775807ULL,
+		9223372036854775808ULL, 18446744073709551615ULL,
+		10000000000000000000ULL, 9999999999999999999ULL,
+	};
+	unsigned long long v = ((unsigned long long)rand() << 40) ^
+			       ((unsigned long long)rand() << 20) ^ rand();
+
+	switch (rand() % 4) {
+	case 0:
+		return edges[rand() % (sizeof(edges) / sizeof(edges[0]))];
+	case 1:
+		return v >> (rand() % 64);
+	default:
+		return v;
+	}
+}
+
+/*
+ * Both sides get the same format and argument, with star arguments in
+ * front when the format has them
+ */
+#define FORMAT_BOTH(ret, buf, n, fmt, sw, sp, arg)			\
+	do {								\
+		if (sw != NO_STAR && sp != NO_STAR) {			\
+			ret[0] = k_snprintf(buf[0], n, fmt, sw, sp, arg); \
+			ret[1] = snprintf(buf[1], n, fmt, sw, sp, arg);	\
+		} else if (sw != NO_STAR || sp != NO_STAR) {		\
+			int st = sw != NO_STAR ? sw : sp;		\
+									\
+			ret[0] = k_snprintf(buf[0], n, fmt, st, arg);	\
+			ret[1] = snprintf(buf[1], n, fmt, st, arg);	\
+		} else {						\
+			ret[0] = k_snprintf(buf[0], n, fmt, arg);	\
+			ret[1] = snprintf(buf[1], n, fmt, arg);		\
+		}							\
+	} while (0)
+
+static void words_out(void *ctx, const char *buf, size_t len)
+{
+	char **p = ctx;
+
+	memcpy(*p, buf, len);
+	*p += len;
+}
+
+/*
+ * snprintf against glibc's, one conversion with random flags per call.
+ * The same conversion from 64-bit words, as log_fast() records them,
+ * has to give the same output too.
+ */
+static void test_snprintf(void)
+{
+	static const char *lengths[] = { "", "hh", "h", "l", "ll", "z", "j" };
+	static const char int_convs[] = "diuxXo";
+	static const char *strings[] = { "", "a", "kopernik", "0123456789abcdef",
+					 NULL };
+	char buf[2][256];
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		char fmt[64];
+		int sw, sp, ret[2];
+		size_t n = rand() % 4 ? sizeof(buf[0]) : rand() % 12;
+		unsigned long long v = interesting_number();
+		int kind = rand() % 8;
+		unsigned long long words[3];
+		unsigned int nw = 0;
+		char wbuf[256], *wp = wbuf;
+
+		memset(buf, 0x5a, sizeof(buf));
+		if (kind < 5) {
+			const char *len = lengths[rand() % 7];
+			char conv = int_convs[rand() % 6];
+
+			random_format(fmt, len, conv, &sw, &sp);
+			if (!strcmp(len, "ll") || !strcmp(len, "z") ||
+			    !strcmp(len, "j") || !strcmp(len, "l"))
+				FORMAT_BOTH(ret, buf, n, fmt, sw, sp, v);
+			else
+				FORMAT_BOTH(ret, buf, n, fmt, sw, sp, (int)v);
+			if (strcmp(len, "ll") && strcmp(len, "z") &&
+			    strcmp(len, "j") && strcmp(len, "l"))
+				v = (long long)(int)v;
+			words[2] = v;
+		} else if (kind == 5) {
+			const char *str = strings[rand() % 5];
+
+			random_format(fmt, "", 's', &sw, &sp);
+			/* glibc prints "" for a NULL %.3s, the kernel "(nu" */
+			if (!str && strchr(fmt, '.'))
+				continue;
+			FORMAT_BOTH(ret, buf, n, fmt, sw, sp, str);
+			words[2] = (unsigned long)str;
+		} else if (kind == 6) {
+			int ch = 'A' + rand() % 26;
+
+			random_format(fmt, "", 'c', &sw, &sp);
+			FORMAT_BOTH(ret, buf, n, fmt, sw, sp, ch);
+			words[2] = ch;
+		} else {
+			/* glibc prints (nil) for NULL, the kernel 0x0 */
+			if (!v)
+				v = 1;
+			random_format(fmt, "", 'p', &sw, &sp);
+			if (strpbrk(fmt, "+ #0") && strchr(fmt, '%') < strpbrk(fmt, "+ #0"))
+				continue;	/* undefined for %p */
+			FORMAT_BOTH(ret, buf, n, fmt, sw, sp, (void *)(unsigned long)v);
+			words[2] = v;
+		}
+
+		if (sw != NO_STAR)
+			words[nw++] = (long long)sw;
+		if (sp != NO_STAR)
+			words[nw++] = (long long)sp;
+		words[nw++] = words[2];
+		/* glibc's output is complete, it fits the buffer */
+		if ((size_t)ret[1] < n) {
+			k_cbprintf_words(words_out, &wp, fmt, words, nw);
+			CHECK(wp - wbuf == ret[1] &&
+			      !memcmp(wbuf, buf[1], ret[1]),
+			      "cbprintf_words \"%s\": \"%.*s\"", fmt,
+			      (int)(wp - wbuf), wbuf);
+		}
+
+		CHECK(ret[0] == ret[1], "snprintf \"%s\" returns %d, glibc %d",
+		      fmt, ret[0], ret[1]);
+		CHECK(!memcmp(buf[0], buf[1], sizeof(buf[0])),
+		      "snprintf \"%s\" size %zu: \"%.*s\", glibc \"%.*s\"", fmt,
+		      n, ret[0] < 200 ? ret[0] : 200, buf[0],
+		      ret[1] < 200 ? ret[1] : 200, buf[1]);
+	}
+}
+
+void libc_test(void)
+{
+	char *m = mmap(NULL, (AREA_PAGES + 2) * PAGE, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (m == MAP_FAILED) {
+		perror("mmap");
+		exit(1);
+	}
+	mprotect(m, PAGE, PROT_NONE);
+	mprotect(m + (AREA_PAGES + 1) * PAGE, PAGE, PROT_NONE);
+	lo = m + PAGE;
+	hi = lo + AREA_PAGES * PAGE;
+	ref = malloc(hi - lo);
+
+	RUN_TEST(test_scan);
+	RUN_TEST(test_compare);
+	RUN_TEST(test_copy);
+	RUN_TEST(test_set);
+	RUN_TEST(test_strlcpy);
+	RUN_TEST(test_snprintf);
+
+	free(ref);
+	munmap(m, (AREA_PAGES + 2) * PAGE);
+}
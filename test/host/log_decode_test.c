@@ -0,0 +1,118 @@
+/*
+ * tools/log_decode.py against cbprintf_words()
+ *
+ * "host_test logdump DUMP EXPECTED" fills log_rings with records the way
+ * log_fast() does and writes them to DUMP, and what log_drain() prints
+ * for them, formatted by the kernel's cbprintf_words(), to EXPECTED.
+ * make host runs the decoder on DUMP with this binary as the image and
+ * compares. The binary is linked without PIE so that the format and %s
+ * pointers in the records are addresses in its ELF file.
+ */
+#include <log.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_test.h"
+
+int k_cbprintf_words(void (*out)(void *ctx, const char *buf, size_t len),
+		     void *ctx, const char *fmt, const unsigned long long *args,
+		     unsigned int nargs);
+
+/* one count of the counter is 1us with the decoder's --freq 1000000 */
+#define LOG_TEST_FREQ	1000000
+
+struct log_ring log_rings[NR_CPUS];
+
+static const struct {
+	const char *fmt;
+	unsigned int nargs;
+	u64 args[LOG_FAST_MAX_ARGS];
+} log_cases[] = {
+	{ "plain text\n" },
+	{ "%d %i %u\n", 3, { -1, 42, -1 } },
+	{ "%+d % d %+d % d\n", 4, { 5, 5, -5, -5 } },
+	{ "%+u % u %+x % o\n", 4, { 5, 5, 0xff, 8 } },
+	{ "[%.0d] [%.0u] [%.0x] [%.0o]\n", 4, { 0, 0, 0, 0 } },
+	{ "[%#.0o] [%#.0x] [%5.0d]\n", 3, { 0, 0, 0 } },
+	{ "%p %p %p\n", 3, { 0, 0x1234, 0xffffffff80001000ULL } },
+	{ "[%20p] [%-20p] [%020p]\n", 3, { 0x40001000, 0x40001000,
+					   0x40001000 } },
+	{ "%#x %#X %#o %#x %#o\n", 5, { 255, 255, 8, 0, 0 } },
+	{ "[%08d] [%-8d] [%08.3d] [%-08d]\n", 4, { -42, 42, 7, 1 } },
+	{ "[%*d] [%*d]\n", 4, { 6, 1, -6, 2 } },
+	{ "[%.*d] [%.*d]\n", 4, { 3, 4, -1, 5 } },
+	{ "%hhd %hhu %hd %hu\n", 4, { 0x1ff, 0x1ff, 0x18000, 0x18000 } },
+	{ "%ld %lu %lld %llx\n", 4, { -2, -2, -3, -3 } },
+	{ "%zu %td %jd %lX\n", 4, { 1ULL << 40, -7, 9, 0xabcdef } },
+	{ "%d %x\n", 2, { 0x100000005ULL, 0x1ffffffffULL } },
+	{ "%c%c%3c%-3c|\n", 4, { 'a', 0x142, 'b', 'c' } },
+	{ "%s|%10s|%-10s|%.3s|\n", 4 },		/* strings filled in below */
+	{ "%s %.*s %5.2s|\n", 4 },
+	{ "missing %d %x\n", 1, { 3 } },
+	{ "100%% %5%\n" },
+};
+
+static const char *log_strings[] = {
+	"hello", "right", "left", "truncated", NULL, "abcdef", "xyz",
+};
+
+static void log_case_args(unsigned int i, u64 *args)
+{
+	if (strstr(log_cases[i].fmt, "%10s")) {
+		args[0] = (unsigned long)log_strings[0];
+		args[1] = (unsigned long)log_strings[1];
+		args[2] = (unsigned long)log_strings[2];
+		args[3] = (unsigned long)log_strings[3];
+	} else if (strstr(log_cases[i].fmt, "%.*s")) {
+		args[0] = (unsigned long)log_strings[4];
+		args[1] = 2;
+		args[2] = (unsigned long)log_strings[5];
+		args[3] = (unsigned long)log_strings[6];
+	}
+}
+
+static void file_out(void *ctx, const char *buf, size_t len)
+{
+	fwrite(buf, 1, len, ctx);
+}
+
+int log_dump(const char *dump, const char *expected)
+{
+	struct log_ring *ring = &log_rings[0];
+	FILE *f = fopen(expected, "w");
+	unsigned int i;
+
+	if (!f) {
+		perror(expected);
+		return 1;
+	}
+
+	for (i = 0; i < sizeof(log_cases) / sizeof(log_cases[0]); i++) {
+		struct log_record *rec = &ring->records[ring->head++];
+
+		rec->stamp = i * 1000001ULL;
+		rec->fmt = log_cases[i].fmt;
+		rec->nargs = log_cases[i].nargs;
+		rec->cpu = 0;
+		memcpy(rec->args, log_cases[i].args, sizeof(rec->args));
+		log_case_args(i, rec->args);
+
+		/* log_print() */
+		fprintf(f, "[%5llu.%06llu] %u: ",
+			rec->stamp / LOG_TEST_FREQ,
+			rec->stamp % LOG_TEST_FREQ, rec->cpu);
+		k_cbprintf_words(file_out, f, rec->fmt,
+				 (const unsigned long long *)rec->args,
+				 rec->nargs);
+	}
+	fclose(f);
+
+	f = fopen(dump, "wb");
+	if (!f) {
+		perror(dump);
+		return 1;
+	}
+	fwrite(log_rings, sizeof(log_rings), 1, f);
+	fclose(f);
+	return 0;
+}
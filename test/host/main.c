@@ -0,0 +1,45 @@
+/*
+ * Native test and benchmark binary for lib/libc and arch/arm64/mmu.c
+ *
+ *   host_test [test|bench]
+ *   host_test logdump DUMP EXPECTED
+ *
+ * Runs the tests, the add_map benchmark or, without an argument, both.
+ * The exit status is 1 if any check failed. logdump writes a log_rings
+ * dump for tools/log_decode.py, see log_decode_test.c.
+ */
+#include <arch_help.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_test.h"
+
+struct host_sysregs host_sysregs;
+unsigned long host_failures;
+
+int main(int argc, char **argv)
+{
+	const char *what = argc > 1 ? argv[1] : "all";
+	int all = !strcmp(what, "all");
+
+	if (!strcmp(what, "logdump") && argc == 4)
+		return log_dump(argv[2], argv[3]);
+
+	if (!all && strcmp(what, "test") && strcmp(what, "bench")) {
+		fprintf(stderr, "usage: %s [test|bench]\n"
+			"       %s logdump DUMP EXPECTED\n", argv[0], argv[0]);
+		return 2;
+	}
+
+	srand(1);
+
+	if (all || !strcmp(what, "test")) {
+		libc_test();
+		mmu_test();
+		printf("%lu failures\n", host_failures);
+	}
+	if (all || !strcmp(what, "bench"))
+		mmu_bench();
+
+	return host_failures ? 1 : 0;
+}
@@ -0,0 +1,353 @@
+/*
+ * add_map() against a reference page-table walker
+ *
+ * The tables are built in memory from the harness through
+ * mmu_set_xlat_tables(). A walker written from the architecture's
+ * descriptor format, not from mmu.h, translates addresses through them
+ * and the result is compared with the last mapping made for each address.
+ * mmu_bench() times add_map() for millions of mappings.
+ */
+#include <arch_help.h>
+#include <mmu.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "host_test.h"
+
+#define SZ_4K		0x1000ULL
+#define SZ_2M		0x200000ULL
+#define SZ_1G		0x40000000ULL
+#define VA_SPACE	(1ULL << 32)
+
+/* Enough tables to map all of VA_SPACE with pages: 4 L2 + 2048 L3 */
+#define POOL_TABLES	2100
+
+#define ROUNDS		300
+#define MAPS_PER_ROUND	40
+#define PROBES		3000
+
+/* kernel/log.c is not part of the host build, mmu.c only reads the levels */
+u8 log_levels[LOG_NR_SUBSYS];
+struct static_key log_keys[LOG_NR_SUBSYS][LOG_NR_KEYS];
+
+/* Descriptor fields, ARM ARM D8.3 */
+#define DESC_VALID	(1ULL << 0)
+#define DESC_TABLE	(1ULL << 1)	/* table at L1/L2, page at L3 */
+#define DESC_ATTRINDX(d)	(((d) >> 2) & 7)
+#define DESC_NS		(1ULL << 5)
+#define DESC_AP_RO	(1ULL << 7)
+#define DESC_SH(d)	(((d) >> 8) & 3)
+#define DESC_AF		(1ULL << 10)
+#define DESC_PXN	(1ULL << 53)
+#define DESC_UXN	(1ULL << 54)
+#define DESC_OA_MASK	0x0000fffffffff000ULL
+#define SH_OUTER	2
+#define SH_INNER	3
+
+struct walk {
+	int valid;
+	int level;
+	u64 pa;
+	u64 desc;
+};
+
+struct region {
+	u64 virt;
+	u64 phys;
+	u64 size;
+	unsigned int attrs;
+};
+
+static u64 (*pool)[XLAT_TABLE_ENTRIES];
+
+static int table_in_pool(u64 addr)
+{
+	u64 start = (u64)(unsigned long)pool;
+
+	return addr >= start && addr < start + POOL_TABLES * SZ_4K &&
+	       !(addr & (SZ_4K - 1));
+}
+
+/* Translate va with a 32-bit VA and 4K granule: L1 [31:30], L2, L3 */
+static struct walk walk(u64 va)
+{
+	struct walk w = { 0 };
+	u64 *table = mmu_base_xlat_table();
+	int level;
+
+	for (level = 1; level <= 3; level++) {
+		int shift = 12 + 9 * (3 - level);
+		u64 desc = table[(va >> shift) & 511];
+		u64 block = 1ULL << shift;
+
+		if (!(desc & DESC_VALID))
+			return w;
+		if (level < 3 && (desc & DESC_TABLE)) {
+			CHECK(table_in_pool(desc & DESC_OA_MASK),
+			      "va %llx: L%d table %llx outside the pool", va,
+			      level, desc);
+			table = (u64 *)(unsigned long)(desc & DESC_OA_MASK);
+			continue;
+		}
+		/* a reserved encoding: block at L3 */
+		CHECK(level < 3 || (desc & DESC_TABLE),
+		      "va %llx: L3 descriptor %llx", va, desc);
+		/* output address bits below the block size are RES0 */
+		CHECK(!(desc & DESC_OA_MASK & (block - 1)),
+		      "va %llx: L%d block %llx not aligned", va, level, desc);
+		w.valid = 1;
+		w.level = level;
+		w.desc = desc;
+		w.pa = (desc & DESC_OA_MASK & ~(block - 1)) | (va & (block - 1));
+		return w;
+	}
+	return w;
+}
+
+/*
+ * The descriptor attribute bits add_map() should produce for attrs. Device
+ * memory is always execute-never, Normal memory stays executable.
+ */
+static u64 expected_attrs(unsigned int attrs)
+{
+	unsigned int type = attrs & 7;
+	u64 desc = DESC_AF | ((u64)type << 2);
+
+	if (attrs & MT_NS)
+		desc |= DESC_NS;
+	if (!(attrs & MT_RW))
+		desc |= DESC_AP_RO;
+	if (type <= MT_DEVICE_GRE)
+		desc |= ((u64)SH_OUTER << 8) | DESC_PXN | DESC_UXN;
+	else if (type == MT_NORMAL_NC)
+		desc |= (u64)SH_OUTER << 8;
+	else
+		desc |= (u64)SH_INNER << 8;
+	return desc;
+}
+
+#define ATTR_BITS	((0x7ffULL & ~(DESC_VALID | DESC_TABLE)) | \
+			 DESC_PXN | DESC_UXN)
+
+static void check_va(const struct region *maps, int nr, u64 va)
+{
+	struct walk w = walk(va);
+	int i;
+
+	/* the last mapping made for va wins */
+	for (i = nr - 1; i >= 0; i--)
+		if (va >= maps[i].virt && va < maps[i].virt + maps[i].size)
+			break;
+
+	if (i < 0) {
+		CHECK(!w.valid, "va %llx: mapped to %llx, expected a fault",
+		      va, w.pa);
+		return;
+	}
+	CHECK(w.valid, "va %llx: fault, expected %llx", va,
+	      maps[i].phys + (va - maps[i].virt));
+	if (!w.valid)
+		return;
+	CHECK(w.pa == maps[i].phys + (va - maps[i].virt),
+	      "va %llx: pa %llx, expected %llx", va, w.pa,
+	      maps[i].phys + (va - maps[i].virt));
+	CHECK((w.desc & ATTR_BITS) == expected_attrs(maps[i].attrs),
+	      "va %llx: L%d attributes %llx, expected %llx for attrs %#x",
+	      va, w.level, w.desc & ATTR_BITS,
+	      expected_attrs(maps[i].attrs), maps[i].attrs);
+}
+
+static u64 rand64(void)
+{
+	return ((u64)rand() << 32) ^ ((u64)rand() << 16) ^ rand();
+}
+
+/*
+ * A random region: runs of pages, 2M blocks with ragged ends, or 1G
+ * blocks, the first two with the physical address aligned like the
+ * virtual one or not
+ */
+static struct region random_region(void)
+{
+	struct region r;
+	u64 align;
+
+	switch (rand() % 8) {
+	case 0:
+		r.size = SZ_1G;
+		align = SZ_1G;
+		break;
+	case 1:
+	case 2:
+	case 3:
+		r.size = SZ_2M * (1 + rand() % 8) +
+			 SZ_4K * (rand() % 2 ? rand() % 512 : 0);
+		align = SZ_2M;
+		break;
+	default:
+		r.size = SZ_4K * (1 + rand() % 700);
+		align = SZ_4K;
+		break;
+	}
+	r.virt = (rand64() % (VA_SPACE - r.size)) & ~(align - 1);
+	r.phys = (rand64() % (VA_SPACE - r.size)) & ~(align - 1);
+	/*
+	 * Misaligned 1G regions would take 513 tables each, and add_map()
+	 * does not free the tables a block replaces: keep those aligned.
+	 */
+	if (align != SZ_1G && rand() % 4 == 0)
+		r.virt = (r.virt + SZ_4K * (1 + rand() % 511)) % (VA_SPACE - r.size);
+	if (align != SZ_1G && rand() % 4 == 0)
+		r.phys += SZ_4K * (rand() % 512);
+
+	r.attrs = rand() % 6;
+	r.attrs |= (rand() & 1) ? MT_RW : MT_RO;
+	r.attrs |= (rand() & 1) ? MT_NS : MT_SECURE;
+	r.attrs |= (rand() & 1) ? MT_P_EXECUTE_NEVER : MT_P_EXECUTE;
+	r.attrs |= (rand() & 1) ? MT_U_EXECUTE_NEVER : MT_U_EXECUTE;
+	return r;
+}
+
+static void test_add_map(void)
+{
+	struct region maps[MAPS_PER_ROUND];
+
+	for (int round = 0; round < ROUNDS; round++) {
+		int nr = 1 + rand() % MAPS_PER_ROUND;
+
+		mmu_set_xlat_tables(pool, POOL_TABLES);
+		for (int i = 0; i < nr; i++) {
+			maps[i] = random_region();
+			add_map("test", maps[i].phys, maps[i].virt,
+				maps[i].size, maps[i].attrs);
+		}
+
+		/* both ends of every region and the pages around them */
+		for (int i = 0; i < nr; i++) {
+			u64 end = maps[i].virt + maps[i].size;
+
+			check_va(maps, nr, maps[i].virt);
+			check_va(maps, nr, maps[i].virt + 0xabc);
+			check_va(maps, nr, end - 1);
+			check_va(maps, nr, end % VA_SPACE);
+			if (maps[i].virt)
+				check_va(maps, nr, maps[i].virt - 1);
+		}
+		for (int i = 0; i < PROBES; i++) {
+			const struct region *r = &maps[rand() % nr];
+
+			check_va(maps, nr, rand() & 1 ?
+				 r->virt + rand64() % r->size :
+				 rand64() % VA_SPACE);
+		}
+	}
+}
+
+/* Running out of tables leaves the rest unmapped but nothing corrupted */
+static void test_exhaustion(void)
+{
+	struct region map = { SZ_1G, 0x80000000ULL, 8 * SZ_2M + SZ_4K, MT_NORMAL };
+
+	/* one L2 table and one L3 table for the 4K tail, nothing for a split */
+	mmu_set_xlat_tables(pool, 2);
+	add_map("test", map.phys, map.virt, map.size, map.attrs);
+	check_va(&map, 1, map.virt);
+	check_va(&map, 1, map.virt + map.size - 1);
+
+	/* splitting one of the 2M blocks needs a third table */
+	add_map("test", 0x1000, map.virt + SZ_4K, SZ_4K, MT_NORMAL);
+	check_va(&map, 1, map.virt + SZ_4K);
+
+	mmu_set_xlat_tables(pool, 0);
+	add_map("test", 0, 0, SZ_4K, MT_NORMAL);
+	CHECK(!walk(0).valid, "mapped without any table");
+}
+
+static void test_enable_mmu(void)
+{
+	mmu_set_xlat_tables(pool, POOL_TABLES);
+	memset(&host_sysregs, 0, sizeof(host_sysregs));
+	enable_mmu();
+
+	CHECK(host_sysregs.mair_el2 == MEMORY_ATTRIBUTES, "MAIR %llx",
+	      (u64)host_sysregs.mair_el2);
+	CHECK(host_sysregs.ttbr0_el2 == (u64)(unsigned long)mmu_base_xlat_table(),
+	      "TTBR0 %llx", (u64)host_sysregs.ttbr0_el2);
+	/* T0SZ for a 32-bit VA, 4K granule */
+	CHECK((host_sysregs.tcr_el2 & 0x3f) == 32 &&
+	      !(host_sysregs.tcr_el2 & (3 << 14)),
+	      "TCR %llx", (u64)host_sysregs.tcr_el2);
+	CHECK((host_sysregs.sctlr_el2 & (SCTLR_M | SCTLR_C)) ==
+	      (SCTLR_M | SCTLR_C), "SCTLR %llx", (u64)host_sysregs.sctlr_el2);
+}
+
+void mmu_test(void)
+{
+	pool = aligned_alloc(SZ_4K, POOL_TABLES * SZ_4K);
+
+	RUN_TEST(test_add_map);
+	RUN_TEST(test_exhaustion);
+	RUN_TEST(test_enable_mmu);
+
+	free(pool);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *what, unsigned long maps, double secs)
+{
+	printf("%-32s %9lu maps %8.1f ms %7.1f ns/map %6.2f Mmaps/s\n", what,
+	       maps, secs * 1e3, secs * 1e9 / maps, maps / secs / 1e6);
+}
+
+#define BENCH_PASSES	4
+
+void mmu_bench(void)
+{
+	unsigned long maps;
+	double t;
+
+	pool = aligned_alloc(SZ_4K, POOL_TABLES * SZ_4K);
+
+	/* every 4K page of the VA space with its own add_map() call */
+	maps = 0;
+	t = now();
+	for (int pass = 0; pass < BENCH_PASSES; pass++) {
+		mmu_set_xlat_tables(pool, POOL_TABLES);
+		for (u64 va = 0; va < VA_SPACE; va += SZ_4K, maps++)
+			add_map("bench", va ^ SZ_2M, va, SZ_4K, MT_NORMAL | MT_RW);
+	}
+	report("add_map 4K, one page per call", maps, now() - t);
+
+	/* the same pages, 1G minus a page per call so no block fits */
+	maps = 0;
+	t = now();
+	for (int pass = 0; pass < BENCH_PASSES; pass++) {
+		mmu_set_xlat_tables(pool, POOL_TABLES);
+		for (u64 va = 0; va < VA_SPACE; va += SZ_1G) {
+			add_map("bench", va + SZ_4K, va, SZ_1G - SZ_4K,
+				MT_NORMAL | MT_RW);
+			maps += (SZ_1G - SZ_4K) / SZ_4K;
+		}
+	}
+	report("add_map 4K, 1G per call", maps, now() - t);
+
+	/* 2M blocks, one per call */
+	maps = 0;
+	t = now();
+	for (int pass = 0; pass < 256 * BENCH_PASSES; pass++) {
+		mmu_set_xlat_tables(pool, POOL_TABLES);
+		for (u64 va = 0; va < VA_SPACE; va += SZ_2M, maps++)
+			add_map("bench", va, va, SZ_2M, MT_DEVICE_nGnRnE | MT_RW);
+	}
+	report("add_map 2M, one block per call", maps, now() - t);
+
+	free(pool);
+}
@@ -0,0 +1,278 @@
+/*
+ * libc micro-benchmarks, built into the image with "make bench"
+ *
+ * Every string routine is timed over sizes from 0 to 1MB and over the
+ * source and destination alignments 0..BENCH_ALIGN_MAX-1. Each point
+ * prints one line:
+ *
+ *   BENCH,<routine>,<size>,<src align>,<dst align>,<iters>,<ticks>,<cycles>
+ *
+ * ticks are CNTVCT_EL0 ticks and cycles PMCCNTR_EL0 cycles for all iters
+ * calls together, cycles is 0 without a PMU. A "BENCH,freq,<hz>" line
+ * gives the counter frequency, "BENCH,cache,<dline>,<zva>" the smallest
+ * data cache line and the DC ZVA block memset uses (0 for none), both in
+ * bytes, and "BENCH,done" ends the table.
+ */
+#include <bench.h>
+#include <cache.h>
+#include <cpufeature.h>
+#include <msr.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <types.h>
+
+#define BENCH_MAX_SIZE		(1024 * 1024)
+#define BENCH_ALIGN_MAX		16
+/* Bytes processed per measurement, the iteration count follows from it */
+#define BENCH_TARGET_BYTES	(256 * 1024)
+#define BENCH_MAX_ITERS		4096
+/* Above this size one side stays aligned while the other is swept */
+#define BENCH_FULL_ALIGN_SIZE	4096
+
+/* PMU registers */
+#define PMCR_E			(1U << 0)
+#define PMCR_C			(1U << 2)
+#define PMCR_LC			(1U << 6)
+#define PMCNTEN_C		(1U << 31)
+#define PMCCFILTR_NSH		(1U << 27)
+
+/* Room for the largest size plus alignment and a string terminator */
+#define BENCH_BUF_SIZE		(BENCH_MAX_SIZE + 2 * BENCH_ALIGN_MAX)
+
+static u8 bench_src[BENCH_BUF_SIZE] __attribute__((aligned(64)));
+static u8 bench_dst[BENCH_BUF_SIZE] __attribute__((aligned(64)));
+
+enum bench_op {
+	OP_MEMCPY,
+	OP_MEMMOVE_FWD,
+	OP_MEMMOVE_BWD,
+	OP_MEMSET,
+	OP_BZERO,
+	OP_MEMCMP,
+	OP_MEMCHR,
+	OP_MEMRCHR,
+	OP_STRLEN,
+	OP_STRNLEN,
+	OP_STRCHR,
+	OP_STRRCHR,
+	OP_STRCMP,
+	OP_STRNCMP,
+	OP_STRLCPY,
+};
+
+struct bench_routine {
+	const char *name;
+	enum bench_op op;
+	bool two_buffers;	/* src and dst alignment both matter */
+	bool string;		/* needs NUL terminated input */
+};
+
+static const struct bench_routine routines[] = {
+	{ "memcpy",		OP_MEMCPY,	true,	false },
+	{ "memmove_fwd",	OP_MEMMOVE_FWD,	true,	false },
+	{ "memmove_bwd",	OP_MEMMOVE_BWD,	true,	false },
+	{ "memset",		OP_MEMSET,	false,	false },
+	{ "bzero",		OP_BZERO,	false,	false },
+	{ "memcmp",		OP_MEMCMP,	true,	false },
+	{ "memchr",		OP_MEMCHR,	false,	false },
+	{ "memrchr",		OP_MEMRCHR,	false,	false },
+	{ "strlen",		OP_STRLEN,	false,	true },
+	{ "strnlen",		OP_STRNLEN,	false,	true },
+	{ "strchr",		OP_STRCHR,	false,	true },
+	{ "strrchr",		OP_STRRCHR,	false,	true },
+	{ "strcmp",		OP_STRCMP,	true,	true },
+	{ "strncmp",		OP_STRNCMP,	true,	true },
+	{ "strlcpy",		OP_STRLCPY,	true,	true },
+};
+
+static bool have_pmu;
+
+static inline u64 read_ticks(void)
+{
+	__asm__ volatile("isb" ::: "memory");
+	return read_msr(cntvct_el0);
+}
+
+static inline u64 read_cycles(void)
+{
+	return have_pmu ? read_msr(pmccntr_el0) : 0;
+}
+
+/* Let PMCCNTR_EL0 count at EL2, 64 bits wide */
+static void pmu_init(void)
+{
+	have_pmu = cpu_has(CPU_FEAT_PMU);
+	if (!have_pmu)
+		return;
+
+	write_msr(pmccfiltr_el0, PMCCFILTR_NSH);
+	write_msr(pmcntenset_el0, PMCNTEN_C);
+	write_msr(pmcr_el0, read_msr(pmcr_el0) | PMCR_E | PMCR_C | PMCR_LC);
+	__asm__ volatile("isb" ::: "memory");
+}
+
+/* Input for the string routines: no NUL and no 'x' before src[size] */
+static void prepare(const struct bench_routine *r, u8 *src, u8 *dst,
+		    size_t size)
+{
+	memset(src, 'a', size);
+	src[size] = '\0';
+	if (r->op == OP_MEMCMP || r->op == OP_STRCMP ||
+	    r->op == OP_STRNCMP) {
+		memset(dst, 'a', size);
+		dst[size] = '\0';
+	}
+}
+
+static void run_op(enum bench_op op, u8 *src, u8 *dst, size_t size,
+		   unsigned int iters)
+{
+	unsigned int i;
+
+	switch (op) {
+	case OP_MEMCPY:
+		for (i = 0; i < iters; i++)
+			memcpy(dst, src, size);
+		break;
+	case OP_MEMMOVE_FWD:
+	case OP_MEMMOVE_BWD:
+		for (i = 0; i < iters; i++)
+			memmove(dst, src, size);
+		break;
+	case OP_MEMSET:
+		for (i = 0; i < iters; i++)
+			memset(dst, 0x5a, size);
+		break;
+	case OP_BZERO:
+		for (i = 0; i < iters; i++)
+			bzero(dst, size);
+		break;
+	case OP_MEMCMP:
+		for (i = 0; i < iters; i++)
+			memcmp(dst, src, size);
+		break;
+	case OP_MEMCHR:
+		for (i = 0; i < iters; i++)
+			memchr(src, 'x', size);
+		break;
+	case OP_MEMRCHR:
+		for (i = 0; i < iters; i++)
+			memrchr(src, 'x', size);
+		break;
+	case OP_STRLEN:
+		for (i = 0; i < iters; i++)
+			strlen((const char *)src);
+		break;
+	case OP_STRNLEN:
+		for (i = 0; i < iters; i++)
+			strnlen((const char *)src, size + 1);
+		break;
+	case OP_STRCHR:
+		for (i = 0; i < iters; i++)
+			strchr((const char *)src, 'x');
+		break;
+	case OP_STRRCHR:
+		for (i = 0; i < iters; i++)
+			strrchr((const char *)src, 'x');
+		break;
+	case OP_STRCMP:
+		for (i = 0; i < iters; i++)
+			strcmp((const char *)dst, (const char *)src);
+		break;
+	case OP_STRNCMP:
+		for (i = 0; i < iters; i++)
+			strncmp((const char *)dst, (const char *)src, size + 1);
+		break;
+	case OP_STRLCPY:
+		for (i = 0; i < iters; i++)
+			strlcpy((char *)dst, (const char *)src, size + 1);
+		break;
+	}
+}
+
+static void bench_point(const struct bench_routine *r, size_t size,
+			unsigned int src_align, unsigned int dst_align)
+{
+	u8 *src = bench_src + src_align;
+	u8 *dst = bench_dst + dst_align;
+	unsigned int iters;
+	u64 t0, t1, c0, c1;
+
+	/* memmove overlaps within bench_src, dst below or above src */
+	if (r->op == OP_MEMMOVE_FWD) {
+		dst = bench_src + dst_align;
+		src = bench_src + BENCH_ALIGN_MAX + src_align;
+	} else if (r->op == OP_MEMMOVE_BWD) {
+		dst = bench_src + BENCH_ALIGN_MAX + dst_align;
+	}
+
+	iters = BENCH_TARGET_BYTES / (size + 64);
+	if (iters == 0)
+		iters = 1;
+	if (iters > BENCH_MAX_ITERS)
+		iters = BENCH_MAX_ITERS;
+
+	prepare(r, src, dst, size);
+	/* one untimed call to warm caches and TLBs */
+	run_op(r->op, src, dst, size, 1);
+
+	c0 = read_cycles();
+	t0 = read_ticks();
+	run_op(r->op, src, dst, size, iters);
+	t1 = read_ticks();
+	c1 = read_cycles();
+
+	printf("BENCH,%s,%u,%u,%u,%u,%llu,%llu\n", r->name,
+	       (unsigned int)size, src_align, dst_align, iters,
+	       (unsigned long long)(t1 - t0), (unsigned long long)(c1 - c0));
+}
+
+/* 0..64 one by one, then 3 points per power of two up to 1MB */
+static size_t next_size(size_t size)
+{
+	size_t pow2;
+
+	if (size < 64)
+		return size + 1;
+	for (pow2 = 64; pow2 * 2 <= size; pow2 *= 2)
+		;
+	if (size == pow2)
+		return pow2 + pow2 / 4;
+	if (size == pow2 + pow2 / 4)
+		return pow2 + pow2 / 2;
+	return pow2 * 2;
+}
+
+static void bench_routine(const struct bench_routine *r)
+{
+	unsigned int sa, da, da_max;
+	size_t size;
+
+	for (size = 0; size <= BENCH_MAX_SIZE; size = next_size(size)) {
+		da_max = r->two_buffers ? BENCH_ALIGN_MAX : 1;
+		for (sa = 0; sa < BENCH_ALIGN_MAX; sa++) {
+			for (da = 0; da < da_max; da++) {
+				/* large sizes: one side aligned, the other swept */
+				if (size > BENCH_FULL_ALIGN_SIZE && sa && da)
+					continue;
+				bench_point(r, size, sa, da);
+			}
+		}
+	}
+}
+
+void libc_bench(void)
+{
+	unsigned int i;
+
+	pmu_init();
+
+	printf("BENCH,freq,%llu\n", (unsigned long long)read_msr(cntfrq_el0));
+	printf("BENCH,cache,%u,%u\n", cache_dline_size(),
+	       cache_zva_block_size());
+	printf("BENCH,routine,size,src_align,dst_align,iters,ticks,cycles\n");
+	for (i = 0; i < sizeof(routines) / sizeof(routines[0]); i++)
+		bench_routine(&routines[i]);
+	printf("BENCH,done\n");
+}
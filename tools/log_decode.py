@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+#
+# Offline decoder for the log_fast() rings
+#
+# Dump the rings from a stopped target, e.g. from gdb:
+#
+#   dump binary memory log.bin &log_rings &log_rings[8]
+#
+# or run ./qemu.sh -semihosting, where main() writes log.bin to the
+# current directory. Then format the pending records with the strings
+# from the image:
+#
+#   tools/log_decode.py Kopernik.elf log.bin
+#
+# The text of the "early: %s" records is in early_console_buf, which is
+# not in the image. Semihosting writes it to early.bin next to log.bin,
+# from gdb it is
+#
+#   dump binary memory early.bin &early_console_buf &early_console_buf[4096]
+#
+# and --early early.bin decodes those records too.
+#
+# The layout below has to match include/log.h. Records of all rings are
+# merged in timestamp order.
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_FAST_MAX_ARGS = 5
+LOG_RING_RECORDS = 256
+RECORD_SIZE = 64
+RECORDS_OFFSET = 128
+RING_SIZE = RECORDS_OFFSET + LOG_RING_RECORDS * RECORD_SIZE
+
+CONV = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?'
+                  r'(hh|h|ll|l|z|t|j)?([diouxXpcs%])')
+INT_BITS = {'hh': 8, 'h': 16, None: 32}
+
+
+class Elf:
+    """Just enough ELF64 to read bytes at a virtual address"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 2:
+            sys.exit('%s: not an ELF64 file' % path)
+        (phoff, shoff) = struct.unpack_from('<QQ', self.data, 0x20)
+        phentsize, phnum, shentsize, shnum = struct.unpack_from(
+            '<HHHH', self.data, 0x36)
+        # (vaddr, bytes) of everything strings can be in
+        self.memory = []
+        for i in range(phnum):
+            (ptype, _, offset, vaddr, _, filesz, _, _) = struct.unpack_from(
+                '<IIQQQQQQ', self.data, phoff + i * phentsize)
+            if ptype == 1:  # PT_LOAD
+                self.memory.append((vaddr,
+                                    self.data[offset:offset + filesz]))
+        self.sections = [struct.unpack_from('<IIQQQQIIQQ', self.data,
+                                            shoff + i * shentsize)
+                         for i in range(shnum)]
+
+    def symbol(self, name):
+        """Address of a symbol from .symtab, None if it is not there"""
+        for sh in self.sections:
+            if sh[1] != 2:  # SHT_SYMTAB
+                continue
+            strtab = self.sections[sh[6]][4]
+            for off in range(sh[4], sh[4] + sh[5], 24):
+                (st_name,) = struct.unpack_from('<I', self.data, off)
+                end = self.data.index(b'\0', strtab + st_name)
+                if self.data[strtab + st_name:end] == name.encode():
+                    return struct.unpack_from('<Q', self.data, off + 8)[0]
+        return None
+
+    def add_memory(self, vaddr, data):
+        self.memory.append((vaddr, data))
+
+    def string(self, addr):
+        for vaddr, data in self.memory:
+            if vaddr <= addr < vaddr + len(data):
+                start = addr - vaddr
+                end = data.find(b'\0', start)
+                end = len(data) if end < 0 else end
+                return data[start:end].decode('ascii', 'replace')
+        return '<bad string %#x>' % addr
+
+
+def to_int(word, length, signed):
+    bits = INT_BITS.get(length, 64)
+    word &= (1 << bits) - 1
+    if signed and word >> (bits - 1):
+        word -= 1 << bits
+    return word
+
+
+def format_num(v, neg, conv, flags, width, prec):
+    """print_num() of lib/libc/vcbprintf.c, prec -1 for none"""
+    if prec == 0 and v == 0:
+        digits = ''
+    elif conv in 'xp':
+        digits = '%x' % v
+    elif conv == 'X':
+        digits = '%X' % v
+    elif conv == 'o':
+        digits = '%o' % v
+    else:
+        digits = '%d' % v
+
+    prefix = ''
+    if neg:
+        prefix = '-'
+    elif conv in 'di':
+        if '+' in flags:
+            prefix = '+'
+        elif ' ' in flags:
+            prefix = ' '
+    if conv == 'p' or ('#' in flags and conv in 'xX' and v):
+        prefix += '0X' if conv == 'X' else '0x'
+
+    zeros = max(prec - len(digits), 0)
+    # the alternate octal form starts with a 0, one from precision will do
+    if '#' in flags and conv == 'o' and not zeros and \
+            (not digits or digits[0] != '0'):
+        zeros = 1
+
+    length = len(prefix) + zeros + len(digits)
+    if width > length and '0' in flags and prec < 0 and '-' not in flags:
+        zeros += width - length
+        length = width
+
+    pad = ' ' * max(width - length, 0)
+    s = prefix + '0' * zeros + digits
+    return s + pad if '-' in flags else pad + s
+
+
+def format_record(elf, fmt, args):
+    """printf() the way lib/libc/vcbprintf.c does, from raw words"""
+    args = list(args)
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    def conv(m):
+        flags, width, prec, length, c = m.groups()
+        if c == '%':
+            return '%'
+        if width == '*':
+            width = to_int(next_arg(), None, True)
+            if width < 0:
+                flags += '-'
+                width = -width
+        if prec == '*':
+            prec = to_int(next_arg(), None, True)
+            prec = -1 if prec < 0 else prec
+        elif prec is not None:
+            prec = int(prec or 0)
+        else:
+            prec = -1
+        width = int(width or 0)
+        word = next_arg()
+
+        if c in 'sc':
+            if c == 'c':
+                s = chr(word & 0xff)
+            else:
+                s = elf.string(word) if word else '(null)'
+                s = s if prec < 0 else s[:prec]
+            return s.ljust(width) if '-' in flags else s.rjust(width)
+        if c == 'p':
+            return format_num(word, False, c, flags, width, prec)
+        if c in 'di':
+            value = to_int(word, length, True)
+            return format_num(abs(value), value < 0, c, flags, width, prec)
+        return format_num(to_int(word, length, False), False, c, flags,
+                          width, prec)
+
+    return CONV.sub(conv, fmt)
+
+
+def records(dump):
+    for cpu in range(len(dump) // RING_SIZE):
+        ring = cpu * RING_SIZE
+        head, dropped = struct.unpack_from('<II', dump, ring)
+        tail, dropped_seen = struct.unpack_from('<II', dump, ring + 64)
+        if dropped != dropped_seen:
+            sys.stderr.write('cpu %u dropped %u records\n' %
+                             (cpu, (dropped - dropped_seen) & 0xffffffff))
+        while tail != head:
+            off = (ring + RECORDS_OFFSET +
+                   (tail % LOG_RING_RECORDS) * RECORD_SIZE)
+            stamp, fmt, nargs, rec_cpu = struct.unpack_from('<QQII', dump, off)
+            args = struct.unpack_from('<%dQ' % LOG_FAST_MAX_ARGS, dump,
+                                      off + 24)
+            yield stamp, rec_cpu, fmt, args[:min(nargs, LOG_FAST_MAX_ARGS)]
+            tail = (tail + 1) & 0xffffffff
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Format a dump of the log_fast() rings')
+    parser.add_argument('elf', help='the image the dump was taken from')
+    parser.add_argument('dump', help='binary dump of log_rings')
+    parser.add_argument('--early', metavar='DUMP',
+                        help='binary dump of early_console_buf')
+    parser.add_argument('--freq', type=int, default=62500000,
+                        help='CNTFRQ_EL0 of the target (default %(default)s)')
+    opts = parser.parse_args()
+
+    elf = Elf(opts.elf)
+    if opts.early:
+        addr = elf.symbol('early_console_buf')
+        if addr is None:
+            sys.exit('%s: no early_console_buf' % opts.elf)
+        with open(opts.early, 'rb') as f:
+            elf.add_memory(addr, f.read())
+    with open(opts.dump, 'rb') as f:
+        dump = f.read()
+
+    for stamp, cpu, fmt, args in sorted(records(dump)):
+        usec = stamp * 1000000 // opts.freq
+        sys.stdout.write('[%5d.%06d] %u: %s' % (usec // 1000000,
+                         usec % 1000000, cpu,
+                         format_record(elf, elf.string(fmt), args)))
+
+
+if __name__ == '__main__':
+    main()